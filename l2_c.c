@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "l2_parser/l2_parse.h"
 #include "l2_drv/l2_assert.h"
 #include "l2_parser/l2_char_stream.h"
@@ -21,13 +22,23 @@ typedef enum _l2_interpreter_input_type {
 typedef struct l2_env_args {
     l2_interpreter_input_type input_type;
     FILE *source_file_p;
+    char *source_path_p;
+    l2_engine_type engine_type;
+    boolean token_cache_enabled; /* the tokens of source file are cached next to it */
+    int max_call_depth;
 
 }l2_env_args;
 
 int l2_init_env(int argc, char *argv[], l2_env_args *env_args_p) {
 
+    env_args_p->input_type = L2_INTERPRETER_INPUT_TYPE_REPL;
+    env_args_p->source_file_p = L2_NULL_PTR;
+    env_args_p->source_path_p = L2_NULL_PTR;
+    env_args_p->engine_type = L2_ENGINE_TYPE_AST;
+    env_args_p->token_cache_enabled = L2_TRUE;
+    env_args_p->max_call_depth = L2_CALL_STACK_MAX_DEPTH;
+
     if (argc <= 1) {
-        env_args_p->input_type = L2_INTERPRETER_INPUT_TYPE_REPL;
         return L2_INIT_ENV_NO_ERROR;
     }
 
@@ -72,9 +83,57 @@ int l2_init_env(int argc, char *argv[], l2_env_args *env_args_p) {
                                     "选项:\n"
                                     "-v: 打印版本信息\n"
                                     "-h: 打印帮助信息\n"
-                            , argv[0]);
+                                    "-x <引擎>: 选择执行引擎, 可选 ast (默认, 解析为语法树后执行), vm (编译为字节码后由虚拟机执行) 或 token (边解析边执行)\n"
+                                    "          ast 和 vm 引擎先解析整个源代码文件, 有语法错误时不执行任何语句; token 引擎执行到出错的语句为止\n"
+                                    "-n: 不使用词法缓存. 默认将源代码文件的词法分析结果写入其旁的缓存文件 (如 foo.l2 对应 foo.l2c),\n"
+                                    "    缓存中只有 token (不含语法树和字节码), 下次运行时由 fread 整块读入以跳过词法分析; 缓存无法写入时忽略\n"
+                                    "-d <层数>: 设置过程调用的最大层数 (默认为 %d), ast 和 vm 引擎的调用栈仅受此限制;\n"
+                                    "          token 引擎在系统栈上递归执行调用, 无论 -d 为多少, 在默认的 8 MB 系统栈上约 2000 层即报告调用栈溢出\n"
+                            , argv[0], L2_CALL_STACK_MAX_DEPTH);
                             exit(0);
 
+                        case 'x': /* select the execution engine */
+                            if (args[cp + 1] != '\0' || i + 1 >= argc) { /* judge the next char and the next argument */
+                                fprintf(stderr, "无效的选项: %s\n使用选项 '-h' 以查看帮助\n", argv[i]);
+                                return L2_INIT_ENV_ERROR_INVALID_OPTION;
+                            }
+
+                            i += 1; /* the engine name is the next argument */
+                            if (!strcmp(argv[i], "ast")) {
+                                env_args_p->engine_type = L2_ENGINE_TYPE_AST;
+                            } else if (!strcmp(argv[i], "vm")) {
+                                env_args_p->engine_type = L2_ENGINE_TYPE_VM;
+                            } else if (!strcmp(argv[i], "token")) {
+                                env_args_p->engine_type = L2_ENGINE_TYPE_TOKEN;
+                            } else {
+                                fprintf(stderr, "无效的执行引擎: %s\n使用选项 '-h' 以查看帮助\n", argv[i]);
+                                return L2_INIT_ENV_ERROR_INVALID_OPTION;
+                            }
+                            break;
+
+                        case 'n': /* disable the token cache */
+                            if (args[cp + 1] != '\0') { /* judge the next char */
+                                fprintf(stderr, "无效的选项: %s\n使用选项 '-h' 以查看帮助\n", argv[i]);
+                                return L2_INIT_ENV_ERROR_INVALID_OPTION;
+                            }
+
+                            env_args_p->token_cache_enabled = L2_FALSE;
+                            break;
+
+                        case 'd': /* set the max depth of procedure calls */
+                            if (args[cp + 1] != '\0' || i + 1 >= argc) { /* judge the next char and the next argument */
+                                fprintf(stderr, "无效的选项: %s\n使用选项 '-h' 以查看帮助\n", argv[i]);
+                                return L2_INIT_ENV_ERROR_INVALID_OPTION;
+                            }
+
+                            i += 1; /* the depth is the next argument */
+                            env_args_p->max_call_depth = atoi(argv[i]);
+                            if (env_args_p->max_call_depth <= 0) {
+                                fprintf(stderr, "无效的调用层数: %s\n使用选项 '-h' 以查看帮助\n", argv[i]);
+                                return L2_INIT_ENV_ERROR_INVALID_OPTION;
+                            }
+                            break;
+
                         default:
                             fprintf(stderr, "无效选项: %s\n使用选项 '-h' 以查看帮助\n", argv[i]);
                             return L2_INIT_ENV_ERROR_INVALID_OPTION;
@@ -83,6 +142,7 @@ int l2_init_env(int argc, char *argv[], l2_env_args *env_args_p) {
 
                 case 2: /* parse path string */
                     env_args_p->input_type = L2_INTERPRETER_INPUT_TYPE_SINGLE_SOURCE_FILE;
+                    env_args_p->source_path_p = argv[i];
                     env_args_p->source_file_p = fopen(argv[i], "r");
                     if (!env_args_p->source_file_p) {
                         fprintf(stderr, "严重错误: 无法打开源代码文件: %s\n", argv[i]);
@@ -106,11 +166,11 @@ int main(int argc, char *argv[]) {
 
     switch (env_args.input_type) {
         case L2_INTERPRETER_INPUT_TYPE_SINGLE_SOURCE_FILE:
-            l2_parse_initialize(env_args.source_file_p);
+            l2_parse_initialize(env_args.source_file_p, env_args.token_cache_enabled ? env_args.source_path_p : L2_NULL_PTR, env_args.engine_type, env_args.max_call_depth);
             break;
 
         case L2_INTERPRETER_INPUT_TYPE_REPL:
-            l2_parse_initialize(stdin);
+            l2_parse_initialize(stdin, L2_NULL_PTR, env_args.engine_type, env_args.max_call_depth);
             break;
 
         default:
@@ -12,7 +12,7 @@ void l2_clean_before_abort() {
     l2_parse_finalize();
 }
 
-void _Noreturn l2_internal_error(const l2_internal_error_type error_type, ...) {
+_Noreturn void l2_internal_error(const l2_internal_error_type error_type, ...) {
     va_list va;
     va_start(va, error_type);
     char *msg;
@@ -61,14 +61,13 @@ void _Noreturn l2_internal_error(const l2_internal_error_type error_type, ...) {
     exit(error_type);
 }
 
-void _Noreturn l2_parsing_error(const l2_parsing_error_type error_type, int lines, int cols, ...) {
+_Noreturn void l2_parsing_error(const l2_parsing_error_type error_type, int lines, int cols, ...) {
 
     va_list va;
     va_start(va, cols);
 
     char illegal_char;
     char *token_str, *token_str2;
-    l2_token *token_p;
 
     switch (error_type) {
         case L2_PARSING_ERROR_ILLEGAL_CHARACTER:
@@ -77,11 +76,6 @@ void _Noreturn l2_parsing_error(const l2_parsing_error_type error_type, int line
             break;
 
         case L2_PARSING_ERROR_UNEXPECTED_TOKEN:
-            token_p = va_arg(va, l2_token *);
-            /*
-            switch (token_p->type) {
-
-            }*/
             fprintf(stderr, "L2 脚本解释错误 (在 %d 行 %d 列附近): \n\t解析到非法词法元素\n", lines, cols);
             break;
 
@@ -233,6 +227,10 @@ void _Noreturn l2_parsing_error(const l2_parsing_error_type error_type, int line
             fprintf(stderr, "L2 脚本解释错误 (在 %d 行 %d 列附近): \n\t不兼容的符号类型\n", lines, cols);
             break;
 
+        case L2_PARSING_ERROR_CALL_STACK_OVERFLOW:
+            fprintf(stderr, "L2 脚本解释错误 (在 %d 行 %d 列附近): \n\t过程调用的层数过深 (已有 %d 层), 调用栈溢出\n", lines, cols, va_arg(va, int));
+            break;
+
         default:
             fprintf(stderr, "L2 脚本解释错误, 出现一个未知错误\n");
     }
@@ -46,13 +46,14 @@ typedef enum _l2_parsing_error_type {
     L2_PARSING_ERROR_TOO_FEW_PARAMETERS,
     L2_PARSING_ERROR_EXPR_RESULT_WITHOUT_VALUE,
     L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE,
-    L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE
+    L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE,
+    L2_PARSING_ERROR_CALL_STACK_OVERFLOW
 }l2_parsing_error_type;
 
 void l2_clean_before_abort();
 /* void l2_internal_error_en(l2_internal_error_type error_type, ...); */
 /* void l2_parsing_error_en(l2_parsing_error_type error_type, int lines, int cols, ...); */
-void _Noreturn l2_internal_error(l2_internal_error_type error_type, ...);
-void _Noreturn l2_parsing_error(l2_parsing_error_type error_type, int lines, int cols, ...);
+_Noreturn void l2_internal_error(l2_internal_error_type error_type, ...);
+_Noreturn void l2_parsing_error(l2_parsing_error_type error_type, int lines, int cols, ...);
 
 #endif
\ No newline at end of file
@@ -7,10 +7,13 @@
 extern l2_parser *g_parser_p;
 
 void l2_gc_free_gc_mem_link(l2_gc_mem_node *gc_mem_link_p) {
-    if (gc_mem_link_p == L2_NULL_PTR) return;
-    l2_gc_free_gc_mem_link(gc_mem_link_p->next);
-    l2_storage_mem_delete(g_parser_p->storage_p, gc_mem_link_p->managed_mem_p);
-    free(gc_mem_link_p);
+    l2_gc_mem_node *next_p;
+
+    for (; gc_mem_link_p != L2_NULL_PTR; gc_mem_link_p = next_p) {
+        next_p = gc_mem_link_p->next;
+        l2_storage_mem_delete(g_parser_p->storage_p, gc_mem_link_p->managed_mem_p);
+        free(gc_mem_link_p);
+    }
 }
 
 l2_gc_list *l2_gc_create() {
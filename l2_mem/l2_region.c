@@ -0,0 +1,53 @@
+#include "memory.h"
+#include "l2_region.h"
+
+#define l2_region_align(mem_size) (((mem_size) + L2_REGION_ALIGNMENT - 1) & ~(l2_mem_size)(L2_REGION_ALIGNMENT - 1))
+
+void l2_region_init(l2_region *region_p) {
+    region_p->chunk_p = L2_NULL_PTR;
+    region_p->top_p = L2_NULL_PTR;
+    region_p->end_p = L2_NULL_PTR;
+}
+
+/* the size of chunks grows twice, so the count of chunks is logarithmic to the size of region */
+void l2_region_grow(l2_storage *storage_p, l2_region *region_p, l2_mem_size mem_size) {
+    l2_mem_size chunk_size = region_p->chunk_p ? region_p->chunk_p->chunk_size * 2 : L2_REGION_INIT_CHUNK_SIZE;
+    l2_region_chunk *chunk_p;
+
+    while (chunk_size < sizeof(l2_region_chunk) + mem_size) chunk_size *= 2;
+
+    chunk_p = l2_storage_mem_new(storage_p, chunk_size);
+    chunk_p->chunk_size = chunk_size;
+    chunk_p->next = region_p->chunk_p;
+    region_p->chunk_p = chunk_p;
+    region_p->top_p = (char *)(chunk_p + 1);
+    region_p->end_p = (char *)chunk_p + chunk_size;
+}
+
+void *l2_region_alloc(l2_storage *storage_p, l2_region *region_p, l2_mem_size mem_size) {
+    void *void_ptr;
+
+    mem_size = l2_region_align(mem_size);
+    if (region_p->end_p - region_p->top_p < (long)mem_size)
+        l2_region_grow(storage_p, region_p, mem_size);
+
+    void_ptr = region_p->top_p;
+    region_p->top_p += mem_size;
+    return void_ptr;
+}
+
+void *l2_region_alloc_with_zero(l2_storage *storage_p, l2_region *region_p, l2_mem_size mem_size) {
+    void *void_ptr = l2_region_alloc(storage_p, region_p, mem_size);
+    memset(void_ptr, 0, mem_size);
+    return void_ptr;
+}
+
+/* the region itself may be allocated in its first chunk, so it is not touched after the chunks are released */
+void l2_region_release(l2_storage *storage_p, l2_region *region_p) {
+    l2_region_chunk *chunk_p, *next_chunk_p;
+
+    for (chunk_p = region_p->chunk_p; chunk_p; chunk_p = next_chunk_p) {
+        next_chunk_p = chunk_p->next;
+        l2_storage_mem_delete(storage_p, chunk_p);
+    }
+}
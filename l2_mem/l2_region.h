@@ -0,0 +1,29 @@
+#ifndef _L2_REGION_H_
+#define _L2_REGION_H_
+
+#include "../l2_tpl/l2_common_type.h"
+#include "l2_storage.h"
+
+#define L2_REGION_ALIGNMENT 16
+#define L2_REGION_INIT_CHUNK_SIZE L2_STORAGE_SLAB_MAX_SIZE /* the first chunk is taken from slab */
+
+typedef struct _l2_region_chunk {
+    struct _l2_region_chunk *next;
+    l2_mem_size chunk_size;
+}l2_region_chunk;
+
+/* the bump pointer allocator, the blocks allocated from region could not be deleted one by one,
+ * all of them are released together when the region is released
+ * */
+typedef struct _l2_region {
+    l2_region_chunk *chunk_p; /* the newest chunk */
+    char *top_p;
+    char *end_p;
+}l2_region;
+
+void l2_region_init(l2_region *region_p);
+void *l2_region_alloc(l2_storage *storage_p, l2_region *region_p, l2_mem_size mem_size);
+void *l2_region_alloc_with_zero(l2_storage *storage_p, l2_region *region_p, l2_mem_size mem_size);
+void l2_region_release(l2_storage *storage_p, l2_region *region_p);
+
+#endif
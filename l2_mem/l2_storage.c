@@ -4,134 +4,175 @@
 #include "../l2_drv/l2_assert.h"
 #include "l2_storage.h"
 
-void l2_storage_free_mem_link(l2_mem_link *mem_link_p) {
-    if (mem_link_p == L2_NULL_PTR) return;
-    free(mem_link_p->mem_p);
-    l2_storage_free_mem_link(mem_link_p->next);
-    free(mem_link_p);
-}
+#define l2_storage_mem_link_of(void_ptr) ((l2_mem_link *)(void_ptr) - 1)
+#define l2_storage_is_slab_size(mem_size) ((mem_size) <= L2_STORAGE_SLAB_MAX_SIZE)
+#define l2_storage_size_class(mem_size) ((mem_size) == 0 ? 0 : ((mem_size) - 1) / L2_STORAGE_SIZE_CLASS_GRANULARITY)
 
+/* the blocks which are still managed while destroying storage are freed here */
 void l2_storage_destroy(l2_storage *storage_p) {
+    l2_mem_link *mem_link, *next_link;
+    l2_mem_chunk *chunk_p, *next_chunk_p;
+
+    for (mem_link = storage_p->head.next; mem_link != &storage_p->head; mem_link = next_link) {
+        next_link = mem_link->next;
+        if (!l2_storage_is_slab_size(mem_link->mem_size)) free(mem_link);
+    }
+
+    for (chunk_p = storage_p->chunks_p; chunk_p; chunk_p = next_chunk_p) {
+        next_chunk_p = chunk_p->next;
+        free(chunk_p);
+    }
+
     storage_p->size = 0;
-    l2_storage_free_mem_link(storage_p->head_p);
-    storage_p->head_p = L2_NULL_PTR;
+    free(storage_p);
 }
 
 l2_storage *l2_storage_create() {
-    l2_storage *storage_p = malloc(sizeof(l2_storage));
-    storage_p->size = 0;
-    storage_p->head_p = L2_NULL_PTR;
+    l2_storage *storage_p = calloc(sizeof(l2_storage), 1);
+    l2_assert(storage_p, L2_INTERNAL_ERROR_NULL_POINTER);
+    storage_p->head.prev = storage_p->head.next = &storage_p->head;
+    storage_p->head.storage_p = storage_p;
     return storage_p;
 }
 
-void *l2_storage_mem_new(l2_storage *storage_p, l2_mem_size mem_size) {
-
-    if (storage_p->head_p) {
-        l2_mem_link *mem_link;
-        for (mem_link = storage_p->head_p; mem_link->next != L2_NULL_PTR; mem_link = mem_link->next);
-        mem_link->next = malloc(sizeof(l2_mem_link));
-        mem_link->next->next = L2_NULL_PTR;
-		l2_assert(mem_link->next->mem_p = malloc(mem_size), L2_INTERNAL_ERROR_NULL_POINTER);
-        storage_p->size += 1;
-        return mem_link->next->mem_p;
+void *l2_storage_link(l2_storage *storage_p, l2_mem_link *mem_link, l2_mem_size mem_size) {
+    l2_assert(mem_link, L2_INTERNAL_ERROR_NULL_POINTER);
+    mem_link->storage_p = storage_p;
+    mem_link->mem_size = mem_size;
+    mem_link->prev = storage_p->head.prev;
+    mem_link->next = &storage_p->head;
+    mem_link->prev->next = mem_link;
+    storage_p->head.prev = mem_link;
+    storage_p->size += 1;
+    return mem_link + 1;
+}
 
-    } else {
-        storage_p->head_p = malloc(sizeof(l2_mem_link));
-        storage_p->head_p->next = L2_NULL_PTR;
-		l2_assert(storage_p->head_p->mem_p = malloc(mem_size), L2_INTERNAL_ERROR_NULL_POINTER);
-        storage_p->size += 1;
-        return storage_p->head_p->mem_p;
-    }
+void l2_storage_unlink(l2_storage *storage_p, l2_mem_link *mem_link) {
+    mem_link->prev->next = mem_link->next;
+    mem_link->next->prev = mem_link->prev;
+    storage_p->size -= 1;
 }
 
-void *l2_storage_mem_new_with_zero(l2_storage *storage_p, l2_mem_size mem_size) {
-    if (storage_p->head_p) {
-        l2_mem_link *mem_link;
-        for (mem_link = storage_p->head_p; mem_link->next != L2_NULL_PTR; mem_link = mem_link->next);
-        mem_link->next = malloc(sizeof(l2_mem_link));
-        mem_link->next->next = L2_NULL_PTR;
-        l2_assert(mem_link->next->mem_p = calloc(mem_size, 1), L2_INTERNAL_ERROR_NULL_POINTER);
-        storage_p->size += 1;
-        return mem_link->next->mem_p;
+/* carve a new chunk into the free blocks of size class */
+void l2_storage_slab_refill(l2_storage *storage_p, int size_class) {
+    l2_mem_size block_size = sizeof(l2_mem_link) + (size_class + 1) * L2_STORAGE_SIZE_CLASS_GRANULARITY;
+    l2_mem_chunk *chunk_p;
+    char *block_p, *end_p;
+    l2_mem_link *mem_link;
 
-    } else {
-        storage_p->head_p = malloc(sizeof(l2_mem_link));
-        storage_p->head_p->next = L2_NULL_PTR;
-        l2_assert(storage_p->head_p->mem_p = calloc(mem_size, 1), L2_INTERNAL_ERROR_NULL_POINTER);
-        storage_p->size += 1;
-        return storage_p->head_p->mem_p;
+    chunk_p = malloc(L2_STORAGE_SLAB_CHUNK_SIZE);
+    l2_assert(chunk_p, L2_INTERNAL_ERROR_NULL_POINTER);
+    chunk_p->chunk_size = L2_STORAGE_SLAB_CHUNK_SIZE;
+    chunk_p->next = storage_p->chunks_p;
+    storage_p->chunks_p = chunk_p;
+
+    end_p = (char *)chunk_p + L2_STORAGE_SLAB_CHUNK_SIZE;
+    for (block_p = (char *)(chunk_p + 1); block_p + block_size <= end_p; block_p += block_size) {
+        mem_link = (l2_mem_link *)block_p;
+        mem_link->storage_p = L2_NULL_PTR;
+        mem_link->next = storage_p->free_lists_p[size_class];
+        storage_p->free_lists_p[size_class] = mem_link;
     }
 }
 
-void *l2_storage_mem_renew(l2_storage *storage_p, void *old_void_ptr, l2_mem_size mem_renew_size) {
-    if (storage_p->head_p == L2_NULL_PTR)
-        l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, old_void_ptr);
+l2_mem_link *l2_storage_slab_alloc(l2_storage *storage_p, l2_mem_size mem_size) {
+    int size_class = l2_storage_size_class(mem_size);
+    l2_mem_link *mem_link;
+
+    if (!storage_p->free_lists_p[size_class])
+        l2_storage_slab_refill(storage_p, size_class);
 
-    void *new_void_ptr = L2_NULL_PTR;
+    mem_link = storage_p->free_lists_p[size_class];
+    storage_p->free_lists_p[size_class] = mem_link->next;
+    return mem_link;
+}
+
+/* returns the header of block, if the block is not managed by this storage, raise an internal error */
+l2_mem_link *l2_storage_get_mem_link(l2_storage *storage_p, void *void_ptr) {
     l2_mem_link *mem_link;
 
-    for (mem_link = storage_p->head_p; mem_link != L2_NULL_PTR; mem_link = mem_link->next) {
-        if (old_void_ptr == mem_link->mem_p) {
-            l2_assert(new_void_ptr = realloc(old_void_ptr, mem_renew_size), L2_INTERNAL_ERROR_NULL_POINTER);
-            mem_link->mem_p = new_void_ptr;
-            return new_void_ptr;
-        }
-    }
+    if (void_ptr == L2_NULL_PTR)
+        l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, void_ptr);
+
+    mem_link = l2_storage_mem_link_of(void_ptr);
+    if (mem_link->storage_p != storage_p)
+        l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, void_ptr);
 
-    l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, old_void_ptr);
+    return mem_link;
 }
 
-void *l2_storage_mem_resize(l2_storage *storage_p, void *old_void_ptr, l2_mem_size mem_old_size, l2_mem_size mem_resize) {
-    if (storage_p->head_p == L2_NULL_PTR)
-        l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, old_void_ptr);
+void *l2_storage_mem_new(l2_storage *storage_p, l2_mem_size mem_size) {
+    if (l2_storage_is_slab_size(mem_size))
+        return l2_storage_link(storage_p, l2_storage_slab_alloc(storage_p, mem_size), mem_size);
 
-    void *new_void_ptr = L2_NULL_PTR;
-    void *temp_p;
-    l2_mem_link *mem_link;
+    return l2_storage_link(storage_p, malloc(sizeof(l2_mem_link) + mem_size), mem_size);
+}
+
+void *l2_storage_mem_new_with_zero(l2_storage *storage_p, l2_mem_size mem_size) {
+    void *void_ptr;
+
+    if (l2_storage_is_slab_size(mem_size)) {
+        void_ptr = l2_storage_link(storage_p, l2_storage_slab_alloc(storage_p, mem_size), mem_size);
+        memset(void_ptr, 0, mem_size);
+        return void_ptr;
+    }
 
-    for (mem_link = storage_p->head_p; mem_link != L2_NULL_PTR; mem_link = mem_link->next) {
-        if (old_void_ptr == mem_link->mem_p) {
-            temp_p = malloc(mem_old_size);
-            memcpy(temp_p, mem_link->mem_p, mem_old_size > mem_resize ? mem_resize : mem_old_size);
-            l2_assert(new_void_ptr = realloc(old_void_ptr, mem_resize), L2_INTERNAL_ERROR_NULL_POINTER);
-            memcpy(new_void_ptr, temp_p, mem_old_size > mem_resize ? mem_resize : mem_old_size);
-            mem_link->mem_p = new_void_ptr;
-            free(temp_p);
-            return new_void_ptr;
+    return l2_storage_link(storage_p, calloc(sizeof(l2_mem_link) + mem_size, 1), mem_size);
+}
+
+void *l2_storage_mem_renew(l2_storage *storage_p, void *old_void_ptr, l2_mem_size mem_renew_size) {
+    l2_mem_link *mem_link = l2_storage_get_mem_link(storage_p, old_void_ptr);
+    void *new_void_ptr;
+
+    /* the slab blocks could not be reallocated, so the content is moved into a new block */
+    if (l2_storage_is_slab_size(mem_link->mem_size) || l2_storage_is_slab_size(mem_renew_size)) {
+        if (l2_storage_size_class(mem_link->mem_size) == l2_storage_size_class(mem_renew_size)
+            && l2_storage_is_slab_size(mem_link->mem_size) && l2_storage_is_slab_size(mem_renew_size)) {
+            mem_link->mem_size = mem_renew_size;
+            return old_void_ptr;
         }
+
+        new_void_ptr = l2_storage_mem_new(storage_p, mem_renew_size);
+        memcpy(new_void_ptr, old_void_ptr, mem_link->mem_size < mem_renew_size ? mem_link->mem_size : mem_renew_size);
+        l2_storage_mem_delete(storage_p, old_void_ptr);
+        return new_void_ptr;
     }
-    l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, old_void_ptr);
+
+    l2_assert(mem_link = realloc(mem_link, sizeof(l2_mem_link) + mem_renew_size), L2_INTERNAL_ERROR_NULL_POINTER);
+
+    /* the block may be moved, so the neighbours are relinked */
+    mem_link->prev->next = mem_link;
+    mem_link->next->prev = mem_link;
+    mem_link->mem_size = mem_renew_size;
+    return mem_link + 1;
+}
+
+/* the content is kept as much as the smaller one of the old block and the new block,
+ * the size of old block is known by its header, so mem_old_size is only kept for compatibility
+ * */
+void *l2_storage_mem_resize(l2_storage *storage_p, void *old_void_ptr, l2_mem_size mem_old_size, l2_mem_size mem_resize) {
+    (void)mem_old_size;
+    return l2_storage_mem_renew(storage_p, old_void_ptr, mem_resize);
 }
 
 void l2_storage_mem_delete(l2_storage *storage_p, void *void_ptr) {
+    l2_mem_link *mem_link = l2_storage_get_mem_link(storage_p, void_ptr);
+    int size_class;
 
-    l2_mem_link *prev_link, *mem_link, *next_link;
-    if (storage_p->head_p == L2_NULL_PTR)
-        l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, void_ptr);
-    else if (void_ptr == storage_p->head_p->mem_p) {
-        free(storage_p->head_p->mem_p);
-        next_link = storage_p->head_p->next;
-        free(storage_p->head_p);
-        storage_p->head_p = next_link;
-        storage_p->size -= 1;
-        return;
-    }
+    l2_storage_unlink(storage_p, mem_link);
 
-    prev_link = storage_p->head_p;
-    for (mem_link = storage_p->head_p->next; mem_link != L2_NULL_PTR; prev_link = prev_link->next, mem_link = mem_link->next) {
-        if (void_ptr == mem_link->mem_p) {
-            free(mem_link->mem_p);
-            next_link = mem_link->next;
-            free(mem_link);
-            prev_link->next = next_link;
-            storage_p->size -= 1;
-            return;
-        }
-    }
+    if (l2_storage_is_slab_size(mem_link->mem_size)) {
+        size_class = l2_storage_size_class(mem_link->mem_size);
+        mem_link->storage_p = L2_NULL_PTR; /* the block in free list is not managed */
+        mem_link->next = storage_p->free_lists_p[size_class];
+        storage_p->free_lists_p[size_class] = mem_link;
 
-    l2_internal_error(L2_INTERNAL_ERROR_MEM_BLOCK_NOT_MANAGED, void_ptr);
+    } else {
+        free(mem_link);
+    }
 }
 
 void l2_storage_mem_copy(l2_storage *storage_p, void *dest_void_ptr, void *src_void_ptr, int size) {
+    (void)storage_p; /* the blocks are not tracked by copy */
     memcpy(dest_void_ptr, src_void_ptr, size);
 }
@@ -3,14 +3,35 @@
 
 #include "../l2_tpl/l2_common_type.h"
 
+#define L2_STORAGE_SIZE_CLASS_GRANULARITY 16
+#define L2_STORAGE_SIZE_CLASSES_COUNT 16 /* the blocks which are not larger than 256 bytes are allocated from slabs */
+#define L2_STORAGE_SLAB_MAX_SIZE (L2_STORAGE_SIZE_CLASS_GRANULARITY * L2_STORAGE_SIZE_CLASSES_COUNT)
+#define L2_STORAGE_SLAB_CHUNK_SIZE 65536
+
+/* the header of each managed memory block, which is allocated just before the block,
+ * all of the blocks of storage are linked into an intrusive circular doubly linked list,
+ * so that new, delete and resize are constant time
+ * */
 typedef struct _l2_mem_link {
-    void *mem_p;
-    struct _l2_mem_link *next;
+    struct _l2_mem_link *prev;
+    struct _l2_mem_link *next; /* the next free block of the same size class, if the block is in free list */
+    struct _l2_storage *storage_p; /* the owner of block */
+    l2_mem_size mem_size; /* also keeps the block aligned as malloc */
 }l2_mem_link;
 
+/* the small blocks are carved from chunks, and they are kept in the free list of their size class after deleted,
+ * the chunks are released only when the storage is destroyed
+ * */
+typedef struct _l2_mem_chunk {
+    struct _l2_mem_chunk *next;
+    l2_mem_size chunk_size;
+}l2_mem_chunk;
+
 typedef struct _l2_storage {
-    l2_mem_link *head_p;
-    int size;
+    l2_mem_link head; /* the sentinel of block list */
+    int size; /* the count of blocks which are not deleted */
+    l2_mem_link *free_lists_p[L2_STORAGE_SIZE_CLASSES_COUNT];
+    l2_mem_chunk *chunks_p;
 
 }l2_storage;
 
@@ -24,4 +45,4 @@ void *l2_storage_mem_resize(l2_storage *storage_p, void *old_void_ptr, l2_mem_si
 void l2_storage_mem_delete(l2_storage *storage_p, void *void_ptr);
 void l2_storage_mem_copy(l2_storage *storage_p, void *dest_void_ptr, void *src_void_ptr, int size);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,1022 @@
+#include "string.h"
+#include "l2_ast.h"
+#include "l2_ast_resolve.h"
+#include "l2_parse.h"
+#include "../l2_drv/l2_error.h"
+#include "../l2_mem/l2_storage.h"
+
+extern l2_parser *g_parser_p;
+
+l2_ast_node *l2_ast_parse_stmts();
+l2_ast_node *l2_ast_parse_expr_assign();
+l2_ast_node *l2_ast_parse_expr_condition();
+l2_ast_node *l2_ast_parse_expr_single();
+
+l2_ast *l2_ast_create() {
+    l2_ast *ast_p;
+    ast_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_ast));
+    ast_p->chunk_p = L2_NULL_PTR;
+    ast_p->loop_level = 0;
+    ast_p->procedure_level = 0;
+    ast_p->global_scope_p = L2_NULL_PTR;
+    ast_p->procedures_count = 0;
+    return ast_p;
+}
+
+void l2_ast_destroy(l2_ast *ast_p) {
+    l2_ast_chunk *chunk_p = ast_p->chunk_p, *next_chunk_p;
+    while (chunk_p) {
+        next_chunk_p = chunk_p->next_p;
+        l2_storage_mem_delete(g_parser_p->storage_p, chunk_p);
+        chunk_p = next_chunk_p;
+    }
+    if (ast_p->global_scope_p) l2_ast_resolve_scope_destroy(ast_p->global_scope_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, ast_p);
+}
+
+/* allocate a node from current chunk, the nodes will not be released until the ast is destroyed ( or rolled back to a mark ),
+ * so that the definition of procedure could be referred by symbol table all the time
+ * */
+l2_ast_node *l2_ast_node_new(l2_ast_node_type type, l2_token *token_p) {
+    l2_ast *ast_p = g_parser_p->ast_p;
+    l2_ast_chunk *chunk_p = ast_p->chunk_p;
+    l2_ast_node *node_p;
+
+    if (!chunk_p || chunk_p->used >= L2_AST_CHUNK_NODES_COUNT) {
+        chunk_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_ast_chunk));
+        chunk_p->next_p = ast_p->chunk_p;
+        ast_p->chunk_p = chunk_p;
+    }
+
+    node_p = &chunk_p->nodes[chunk_p->used++];
+    node_p->type = type;
+    node_p->line = token_p->current_line;
+    node_p->col = token_p->current_col;
+    return node_p;
+}
+
+l2_ast_mark l2_ast_get_mark() {
+    l2_ast_mark mark;
+    mark.chunk_p = g_parser_p->ast_p->chunk_p;
+    mark.used = mark.chunk_p ? mark.chunk_p->used : 0;
+    mark.procedures_count = g_parser_p->ast_p->procedures_count;
+    return mark;
+}
+
+/* release the nodes allocated since mark ( the stmts executed in streaming mode ), returns true if they are released,
+ * they are kept if any procedure is defined by them, and the mark is moved to the current position
+ * */
+boolean l2_ast_release_since(l2_ast_mark *mark_p) {
+    l2_ast *ast_p = g_parser_p->ast_p;
+    l2_ast_chunk *chunk_p;
+
+    if (ast_p->procedures_count != mark_p->procedures_count) {
+        *mark_p = l2_ast_get_mark();
+        return L2_FALSE;
+    }
+
+    while (ast_p->chunk_p != mark_p->chunk_p) {
+        chunk_p = ast_p->chunk_p;
+        ast_p->chunk_p = chunk_p->next_p;
+        l2_storage_mem_delete(g_parser_p->storage_p, chunk_p);
+    }
+
+    /* the nodes are allocated with zero */
+    if ((chunk_p = ast_p->chunk_p)) {
+        memset(&chunk_p->nodes[mark_p->used], 0, (chunk_p->used - mark_p->used) * sizeof(l2_ast_node));
+        chunk_p->used = mark_p->used;
+    }
+    return L2_TRUE;
+}
+
+boolean l2_ast_is_assign_opr(l2_token_type type) {
+    switch (type) {
+        case L2_TOKEN_ASSIGN:
+        case L2_TOKEN_PLUS_ASSIGN:
+        case L2_TOKEN_SUB_ASSIGN:
+        case L2_TOKEN_MUL_ASSIGN:
+        case L2_TOKEN_DIV_ASSIGN:
+        case L2_TOKEN_MOD_ASSIGN:
+        case L2_TOKEN_RSHIFT_ASSIGN:
+        case L2_TOKEN_RSHIFT_UNSIGNED_ASSIGN:
+        case L2_TOKEN_LSHIFT_ASSIGN:
+        case L2_TOKEN_BIT_AND_ASSIGN:
+        case L2_TOKEN_BIT_XOR_ASSIGN:
+        case L2_TOKEN_BIT_OR_ASSIGN:
+            return L2_TRUE;
+
+        default:
+            return L2_FALSE;
+    }
+}
+
+/* the string of operator, using for error report */
+char *l2_ast_str_opr(l2_token_type type) {
+    switch (type) {
+        case L2_TOKEN_LOGIC_NOT: return "!";
+        case L2_TOKEN_BIT_NOT: return "~";
+        case L2_TOKEN_MUL: return "*";
+        case L2_TOKEN_DIV: return "/";
+        case L2_TOKEN_MOD: return "%";
+        case L2_TOKEN_PLUS: return "+";
+        case L2_TOKEN_SUB: return "-";
+        case L2_TOKEN_RSHIFT: return ">>";
+        case L2_TOKEN_RSHIFT_UNSIGNED: return ">>>";
+        case L2_TOKEN_LSHIFT: return "<<";
+        case L2_TOKEN_GREAT_THAN: return ">";
+        case L2_TOKEN_GREAT_EQUAL_THAN: return ">=";
+        case L2_TOKEN_LESS_THAN: return "<";
+        case L2_TOKEN_LESS_EQUAL_THAN: return "<=";
+        case L2_TOKEN_EQUAL: return "==";
+        case L2_TOKEN_NOT_EQUAL: return "!=";
+        case L2_TOKEN_BIT_AND: return "&";
+        case L2_TOKEN_BIT_XOR: return "^";
+        case L2_TOKEN_BIT_OR: return "|";
+        case L2_TOKEN_LOGIC_AND: return "&&";
+        case L2_TOKEN_LOGIC_OR: return "||";
+        case L2_TOKEN_ASSIGN: return "=";
+        case L2_TOKEN_PLUS_ASSIGN: return "+=";
+        case L2_TOKEN_SUB_ASSIGN: return "-=";
+        case L2_TOKEN_MUL_ASSIGN: return "*=";
+        case L2_TOKEN_DIV_ASSIGN: return "/=";
+        case L2_TOKEN_MOD_ASSIGN: return "%=";
+        case L2_TOKEN_RSHIFT_ASSIGN: return ">>=";
+        case L2_TOKEN_RSHIFT_UNSIGNED_ASSIGN: return ">>>=";
+        case L2_TOKEN_LSHIFT_ASSIGN: return "<<=";
+        case L2_TOKEN_BIT_AND_ASSIGN: return "&=";
+        case L2_TOKEN_BIT_XOR_ASSIGN: return "^=";
+        case L2_TOKEN_BIT_OR_ASSIGN: return "|=";
+        default: return "";
+    }
+}
+
+/* program ->
+ * | stmts eof
+ * */
+l2_ast_node *l2_ast_parse_program() {
+    l2_ast_node *stmts_p = l2_ast_parse_stmts();
+
+    _if_type (L2_TOKEN_TERMINATOR)
+    {
+        /* reach the end of source */
+    } _throw_unexpected_token
+
+    return stmts_p;
+}
+
+/* stmts ->
+ * | stmt stmts
+ * | nil
+ *
+ * */
+l2_ast_node *l2_ast_parse_stmts() {
+    l2_ast_node *head_p = L2_NULL_PTR, *tail_p = L2_NULL_PTR, *stmt_p;
+
+    while ((stmt_p = l2_ast_parse_stmt())) {
+        if (tail_p) tail_p->next_p = stmt_p;
+        else head_p = stmt_p;
+        tail_p = stmt_p;
+    }
+    return head_p;
+}
+
+/* { stmts } */
+l2_ast_node *l2_ast_parse_stmts_block() {
+    l2_ast_node *stmts_p = L2_NULL_PTR;
+
+    _if_type (L2_TOKEN_LBRACE) /* { */
+    {
+        stmts_p = l2_ast_parse_stmts();
+
+        _if_type (L2_TOKEN_RBRACE) /* } */
+        {
+            /* absorb '}' */
+        } _throw_missing_rbrace
+
+    } _throw_unexpected_token
+
+    return stmts_p;
+}
+
+/* loop body, in which break and continue are allowed */
+l2_ast_node *l2_ast_parse_loop_block() {
+    l2_ast_node *stmts_p;
+
+    g_parser_p->ast_p->loop_level += 1;
+    stmts_p = l2_ast_parse_stmts_block();
+    g_parser_p->ast_p->loop_level -= 1;
+
+    return stmts_p;
+}
+
+/* an expr must be here */
+l2_ast_node *l2_ast_parse_expr_required() {
+    l2_ast_node *expr_p = l2_ast_parse_expr();
+
+    _if (expr_p) {
+
+    } _throw_unexpected_token
+
+    return expr_p;
+}
+
+/* stmt_var_def_list ->
+ * | id stmt_var_def_list1
+ * | id = expr_assign stmt_var_def_list1
+ *
+ * stmt_var_def_list1 ->
+ * | , id stmt_var_def_list1
+ * | , id = expr_assign stmt_var_def_list1
+ * | nil
+ * */
+l2_ast_node *l2_ast_parse_stmt_var_def_list() {
+    l2_ast_node *head_p = L2_NULL_PTR, *tail_p = L2_NULL_PTR, *def_p;
+
+    while (1) {
+        _if_type (L2_TOKEN_IDENTIFIER) /* id */
+        {
+            l2_token *id_p = l2_parse_token_current();
+            def_p = l2_ast_node_new(L2_AST_VAR_DEF, id_p);
+            def_p->u.var_def.id = id_p->u.id.str_p;
+
+            _if_type (L2_TOKEN_ASSIGN) /* = */
+            {
+                def_p->u.var_def.init_p = l2_ast_parse_expr_assign();
+
+                _if (def_p->u.var_def.init_p) {
+
+                } _throw_unexpected_token
+
+            } _end
+
+        } _throw_unexpected_token
+
+        if (tail_p) tail_p->next_p = def_p;
+        else head_p = def_p;
+        tail_p = def_p;
+
+        _if_type (L2_TOKEN_COMMA) /* , */
+        {
+            /* absorb ',' and handle the next definition */
+        }
+        _else
+        {
+            break;
+        }
+    }
+
+    return head_p;
+}
+
+/* formal_param_list ->
+ * | id formal_param_list1
+ * | nil
+ *
+ * formal_param_list1 ->
+ * | , id formal_param_list1
+ * | nil
+ * */
+l2_ast_node *l2_ast_parse_formal_param_list(int *params_count_p) {
+    l2_ast_node *head_p = L2_NULL_PTR, *tail_p = L2_NULL_PTR, *param_p, *p;
+    l2_token *id_p;
+
+    *params_count_p = 0;
+
+    if (l2_parse_probe_next_token_by_type(L2_TOKEN_IDENTIFIER)) {
+        while (1) {
+            _if_type (L2_TOKEN_IDENTIFIER)
+            {
+                id_p = l2_parse_token_current();
+
+                /* the formal parameters must be different from each other */
+                for (p = head_p; p; p = p->next_p) {
+                    if (p->u.var_def.id == id_p->u.id.str_p)
+                        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, id_p->current_line, id_p->current_col, id_p->u.id.str_p);
+                }
+
+                param_p = l2_ast_node_new(L2_AST_VAR_DEF, id_p);
+                param_p->u.var_def.id = id_p->u.id.str_p;
+
+            } _throw_unexpected_token
+
+            if (tail_p) tail_p->next_p = param_p;
+            else head_p = param_p;
+            tail_p = param_p;
+            *params_count_p += 1;
+
+            _if_type (L2_TOKEN_COMMA) /* , */
+            {
+                /* absorb ',' and handle the next parameter */
+            }
+            _else
+            {
+                break;
+            }
+        }
+    }
+
+    return head_p;
+}
+
+/* stmt_elif ->
+ * | elif ( expr ) { stmts } stmt_elif
+ * | else { stmts }
+ * | nil
+ *
+ * */
+l2_ast_node *l2_ast_parse_stmt_elif() {
+    l2_ast_node *node_p = L2_NULL_PTR;
+
+    _if_keyword (L2_KW_ELIF) /* "elif" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_IF, l2_parse_token_current());
+
+        _if_type (L2_TOKEN_LP) /* ( */
+        {
+            node_p->u.branch.cond_p = l2_ast_parse_expr_required();
+
+            _if_type (L2_TOKEN_RP)
+            {
+                /* absorb ')' */
+            } _throw_missing_rp
+
+        } _throw_unexpected_token
+
+        node_p->u.branch.then_p = l2_ast_parse_stmts_block();
+        node_p->u.branch.else_p = l2_ast_parse_stmt_elif();
+    }
+    _elif_keyword (L2_KW_ELSE) /* "else" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_BLOCK, l2_parse_token_current());
+        node_p->u.block.stmts_p = l2_ast_parse_stmts_block();
+    }
+    _end
+
+    return node_p;
+}
+
+/* stmt ->
+ * | { stmts }
+ * | procedure id ( formal_param_list ) { stmts }
+ * | while ( expr ) { stmts }
+ * | do { stmts } while ( expr ) ;
+ * | for ( expr ; expr ; expr ) { stmts }
+ * | for ( var stmt_var_def_list ; expr ; expr ) { stmts }
+ * | break ;
+ * | continue ;
+ * | return ;
+ * | return expr ;
+ * | if ( expr ) { stmts } stmt_elif
+ * | var stmt_var_def_list ;
+ * | ;
+ * | expr ;
+ * | eval expr;
+ * | nil ( returns null )
+ * */
+l2_ast_node *l2_ast_parse_stmt() {
+    l2_ast *ast_p = g_parser_p->ast_p;
+    l2_ast_node *node_p;
+
+    _if_keyword (L2_KW_BREAK) /* "break" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_BREAK, l2_parse_token_current());
+
+        _if_type (L2_TOKEN_SEMICOLON)
+        {
+            /* absorb ';' */
+        } _throw_missing_semicolon
+
+        if (ast_p->loop_level <= 0)
+            l2_parsing_error(L2_PARSING_ERROR_INVALID_BREAK_IN_CURRENT_CONTEXT, node_p->line, node_p->col);
+    }
+    _elif_keyword (L2_KW_CONTINUE) /* "continue" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_CONTINUE, l2_parse_token_current());
+
+        _if_type (L2_TOKEN_SEMICOLON)
+        {
+            /* absorb ';' */
+        } _throw_missing_semicolon
+
+        if (ast_p->loop_level <= 0)
+            l2_parsing_error(L2_PARSING_ERROR_INVALID_CONTINUE_IN_CURRENT_CONTEXT, node_p->line, node_p->col);
+    }
+    _elif_keyword (L2_KW_RETURN) /* "return" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_RETURN, l2_parse_token_current());
+
+        if (ast_p->procedure_level <= 0)
+            l2_parsing_error(L2_PARSING_ERROR_INVALID_RETURN_IN_CURRENT_CONTEXT, node_p->line, node_p->col);
+
+        _if_type (L2_TOKEN_SEMICOLON)
+        {
+            /* has no return value */
+        }
+        _else
+        {
+            node_p->u.stmt_expr.expr_p = l2_ast_parse_expr_required();
+
+            _if_type (L2_TOKEN_SEMICOLON)
+            {
+                /* absorb ';' */
+            } _throw_missing_semicolon
+        }
+    }
+    _elif_keyword (L2_KW_PROCEDURE) /* "procedure" */ /* the definition of procedure */
+    {
+        _if_type (L2_TOKEN_IDENTIFIER) /* id */
+        {
+            l2_token *id_p = l2_parse_token_current();
+            node_p = l2_ast_node_new(L2_AST_STMT_PROCEDURE, id_p);
+            ast_p->procedures_count += 1;
+            node_p->u.procedure.id = id_p->u.id.str_p;
+
+            _if_type (L2_TOKEN_LP) /* ( */
+            {
+                node_p->u.procedure.params_p = l2_ast_parse_formal_param_list(&node_p->u.procedure.params_count);
+
+                _if_type (L2_TOKEN_RP)
+                {
+                    /* absorb ')' */
+                } _throw_missing_rp
+
+            } _throw_unexpected_token
+
+            /* break and continue could not go through the procedure */
+            int outer_loop_level = ast_p->loop_level;
+            ast_p->loop_level = 0;
+            ast_p->procedure_level += 1;
+
+            node_p->u.procedure.body_p = l2_ast_parse_stmts_block();
+
+            ast_p->procedure_level -= 1;
+            ast_p->loop_level = outer_loop_level;
+
+        } _throw_unexpected_token
+    }
+    _elif_keyword (L2_KW_FOR) /* "for" */ /* for-loop */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_FOR, l2_parse_token_current());
+
+        _if_type (L2_TOKEN_LP) /* ( */
+        {
+            /* handle the first expr ( allow to using definition stmt for variable ) */
+            _if_keyword (L2_KW_VAR)
+            {
+                node_p->u.for_loop.init_p = l2_ast_node_new(L2_AST_STMT_VAR, l2_parse_token_current());
+                node_p->u.for_loop.init_p->u.var.defs_p = l2_ast_parse_stmt_var_def_list();
+
+                _if_type (L2_TOKEN_SEMICOLON)
+                {
+                    /* absorb ';' */
+                } _throw_missing_semicolon
+            }
+            _elif_type (L2_TOKEN_SEMICOLON)
+            {
+                /* this means there is an empty expr in for-loop */
+            }
+            _else
+            {
+                l2_ast_node *init_expr_p = l2_ast_parse_expr_required();
+                node_p->u.for_loop.init_p = l2_ast_node_new(L2_AST_STMT_EXPR, l2_parse_token_current());
+                node_p->u.for_loop.init_p->line = init_expr_p->line;
+                node_p->u.for_loop.init_p->col = init_expr_p->col;
+                node_p->u.for_loop.init_p->u.stmt_expr.expr_p = init_expr_p;
+
+                _if_type (L2_TOKEN_SEMICOLON)
+                {
+                    /* absorb ';' */
+                } _throw_missing_semicolon
+            }
+
+            /* the second expr will have a bool-value with true if it is empty */
+            _if_type (L2_TOKEN_SEMICOLON)
+            {
+                /* also absorb ';' */
+            }
+            _else
+            {
+                node_p->u.for_loop.cond_p = l2_ast_parse_expr_required();
+
+                _if_type (L2_TOKEN_SEMICOLON)
+                {
+                    /* absorb ';' */
+                } _throw_missing_semicolon
+            }
+
+            _if_type (L2_TOKEN_RP)
+            {
+                /* this means there is an empty expr in for-loop */
+            }
+            _else
+            {
+                node_p->u.for_loop.step_p = l2_ast_parse_expr_required();
+
+                _if_type (L2_TOKEN_RP)
+                {
+                    /* absorb ')' */
+                } _throw_missing_rp
+            }
+
+        } _throw_unexpected_token
+
+        node_p->u.for_loop.body_p = l2_ast_parse_loop_block();
+    }
+    _elif_keyword (L2_KW_DO) /* "do" */ /* do...while-loop */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_DO_WHILE, l2_parse_token_current());
+        node_p->u.loop.body_p = l2_ast_parse_loop_block();
+
+        _if_keyword (L2_KW_WHILE) /* "while" */
+        {
+            /* the error of loop condition is reported at "while" */
+            node_p->line = l2_parse_token_current()->current_line;
+            node_p->col = l2_parse_token_current()->current_col;
+
+            _if_type (L2_TOKEN_LP) /* ( */
+            {
+                node_p->u.loop.cond_p = l2_ast_parse_expr_required();
+
+            } _throw_unexpected_token
+
+            _if_type (L2_TOKEN_RP) /* ) */
+            {
+                /* absorb ')' */
+            } _throw_missing_rp
+
+            _if_type (L2_TOKEN_SEMICOLON) /* ; */
+            {
+                /* absorb ';' */
+            } _throw_missing_semicolon
+
+        } _throw_unexpected_token
+    }
+    _elif_keyword (L2_KW_WHILE) /* "while" */ /* while-loop */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_WHILE, l2_parse_token_current());
+
+        _if_type (L2_TOKEN_LP) /* ( */
+        {
+            node_p->u.loop.cond_p = l2_ast_parse_expr_required();
+
+            _if_type (L2_TOKEN_RP)
+            {
+                /* absorb ')' */
+            } _throw_missing_rp
+
+        } _throw_unexpected_token
+
+        node_p->u.loop.body_p = l2_ast_parse_loop_block();
+    }
+    _elif_type (L2_TOKEN_LBRACE) /* { */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_BLOCK, l2_parse_token_current());
+        node_p->u.block.stmts_p = l2_ast_parse_stmts();
+
+        _if_type (L2_TOKEN_RBRACE) /* } */
+        {
+            /* absorb '}' */
+        } _throw_missing_rbrace
+    }
+    _elif_keyword (L2_KW_IF) /* "if" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_IF, l2_parse_token_current());
+
+        _if_type (L2_TOKEN_LP) /* ( */
+        {
+            node_p->u.branch.cond_p = l2_ast_parse_expr_required();
+
+            _if_type (L2_TOKEN_RP)
+            {
+                /* absorb ')' */
+            } _throw_missing_rp
+
+        } _throw_unexpected_token
+
+        node_p->u.branch.then_p = l2_ast_parse_stmts_block();
+        node_p->u.branch.else_p = l2_ast_parse_stmt_elif();
+    }
+    _elif_type (L2_TOKEN_SEMICOLON)
+    {
+        /* empty stmt which has only single ; */
+        node_p = l2_ast_node_new(L2_AST_STMT_EMPTY, l2_parse_token_current());
+    }
+    _elif_keyword (L2_KW_VAR) /* "var" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_VAR, l2_parse_token_current());
+        node_p->u.var.defs_p = l2_ast_parse_stmt_var_def_list();
+
+        _if_type (L2_TOKEN_SEMICOLON)
+        {
+            /* absorb ';' */
+        } _throw_missing_semicolon
+    }
+    _elif_keyword (L2_KW_EVAL) /* "eval" */
+    {
+        node_p = l2_ast_node_new(L2_AST_STMT_EVAL, l2_parse_token_current());
+        node_p->u.stmt_expr.expr_p = l2_ast_parse_expr_required();
+
+        _if_type (L2_TOKEN_SEMICOLON)
+        {
+            /* absorb ';' */
+        } _throw_missing_semicolon
+    }
+    _else
+    {
+        l2_ast_node *expr_p = l2_ast_parse_expr();
+        if (!expr_p) return L2_NULL_PTR; /* it's not a stmt */
+
+        node_p = l2_ast_node_new(L2_AST_STMT_EXPR, l2_parse_token_current());
+        node_p->line = expr_p->line;
+        node_p->col = expr_p->col;
+        node_p->u.stmt_expr.expr_p = expr_p;
+
+        _if_type (L2_TOKEN_SEMICOLON)
+        {
+            /* absorb ';' */
+        } _throw_missing_semicolon
+    }
+
+    return node_p;
+}
+
+l2_ast_node *l2_ast_parse_expr() {
+    l2_ast_node *left_p, *node_p;
+
+    /* expr_comma ->
+     * | expr_comma , expr_assign
+     * | expr_assign
+     * */
+    left_p = l2_ast_parse_expr_assign();
+    if (!left_p) return L2_NULL_PTR;
+
+    while (l2_parse_probe_next_token_by_type(L2_TOKEN_COMMA)) {
+        l2_parse_token_forward();
+
+        node_p = l2_ast_node_new(L2_AST_EXPR_COMMA, l2_parse_token_current());
+        node_p->u.binary.opr = L2_TOKEN_COMMA;
+        node_p->u.binary.left_p = left_p;
+        node_p->u.binary.right_p = l2_ast_parse_expr_assign();
+
+        _if (node_p->u.binary.right_p) {
+
+        } _throw_unexpected_token
+
+        left_p = node_p;
+    }
+
+    return left_p;
+}
+
+/* expr_assign ->
+ * | id = expr_assign
+ * | id /= expr_assign
+ * | id *= expr_assign
+ * | id %= expr_assign
+ * | id += expr_assign
+ * | id -= expr_assign
+ * | id <<= expr_assign
+ * | id >>= expr_assign
+ * | id >>>= expr_assign
+ * | id &= expr_assign
+ * | id ^= expr_assign
+ * | id |= expr_assign
+ * | expr_condition
+ *
+ * */
+l2_ast_node *l2_ast_parse_expr_assign() {
+    l2_ast_node *node_p;
+    l2_token id, *opr_p;
+
+    _if_type (L2_TOKEN_IDENTIFIER)
+    {
+        /* the token vector may be reallocated by forwarding, so the id token is copied */
+        id = *l2_parse_token_current();
+        l2_parse_token_forward();
+        opr_p = l2_parse_token_current();
+
+        if (l2_ast_is_assign_opr(opr_p->type)) {
+            node_p = l2_ast_node_new(L2_AST_EXPR_ASSIGN, opr_p);
+            node_p->u.assign.opr = opr_p->type;
+            node_p->u.assign.id = id.u.id.str_p;
+            node_p->u.assign.id_line = id.current_line;
+            node_p->u.assign.id_col = id.current_col;
+            node_p->u.assign.right_p = l2_ast_parse_expr_assign();
+
+            _if (node_p->u.assign.right_p) {
+
+            } _throw_unexpected_token
+
+            return node_p;
+        }
+
+        /* no match, rollback both operator and id */
+        l2_parse_token_back();
+        l2_parse_token_back();
+
+    } _end
+
+    return l2_ast_parse_expr_condition();
+}
+
+/* parse the left associative dualistic operators at the same level of priority */
+l2_ast_node *l2_ast_parse_expr_dualistic(l2_ast_node *(*parse_operand)(), const l2_token_type *oprs, int oprs_count) {
+    l2_ast_node *left_p, *node_p;
+    l2_token *opr_p;
+    int i;
+
+    left_p = parse_operand();
+    if (!left_p) return L2_NULL_PTR;
+
+    while (1) {
+        l2_parse_token_forward();
+        opr_p = l2_parse_token_current();
+
+        for (i = 0; i < oprs_count; i++) {
+            if (opr_p->type == oprs[i]) break;
+        }
+
+        if (i == oprs_count) { /* no match */
+            l2_parse_token_back();
+            return left_p;
+        }
+
+        node_p = l2_ast_node_new(L2_AST_EXPR_BINARY, opr_p);
+        node_p->u.binary.opr = opr_p->type;
+        node_p->u.binary.left_p = left_p;
+        node_p->u.binary.right_p = parse_operand();
+
+        _if (node_p->u.binary.right_p) {
+
+        } _throw_unexpected_token
+
+        left_p = node_p;
+    }
+}
+
+/* expr_mul_div_mod ->
+ * | expr_mul_div_mod * expr_single
+ * | expr_mul_div_mod / expr_single
+ * | expr_mul_div_mod % expr_single
+ * | expr_single
+ * */
+l2_ast_node *l2_ast_parse_expr_mul_div_mod() {
+    static const l2_token_type oprs[] = { L2_TOKEN_MUL, L2_TOKEN_DIV, L2_TOKEN_MOD };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_single, oprs, 3);
+}
+
+/* expr_plus_sub ->
+ * | expr_plus_sub + expr_mul_div_mod
+ * | expr_plus_sub - expr_mul_div_mod
+ * | expr_mul_div_mod
+ * */
+l2_ast_node *l2_ast_parse_expr_plus_sub() {
+    static const l2_token_type oprs[] = { L2_TOKEN_PLUS, L2_TOKEN_SUB };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_mul_div_mod, oprs, 2);
+}
+
+/* expr_lshift_rshift_rshift_unsigned ->
+ * | expr_lshift_rshift_rshift_unsigned << expr_plus_sub
+ * | expr_lshift_rshift_rshift_unsigned >> expr_plus_sub
+ * | expr_lshift_rshift_rshift_unsigned >>> expr_plus_sub
+ * | expr_plus_sub
+ * */
+l2_ast_node *l2_ast_parse_expr_lshift_rshift_rshift_unsigned() {
+    static const l2_token_type oprs[] = { L2_TOKEN_LSHIFT, L2_TOKEN_RSHIFT, L2_TOKEN_RSHIFT_UNSIGNED };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_plus_sub, oprs, 3);
+}
+
+/* expr_gt_lt_ge_le ->
+ * | expr_gt_lt_ge_le > expr_lshift_rshift_rshift_unsigned
+ * | expr_gt_lt_ge_le < expr_lshift_rshift_rshift_unsigned
+ * | expr_gt_lt_ge_le >= expr_lshift_rshift_rshift_unsigned
+ * | expr_gt_lt_ge_le <= expr_lshift_rshift_rshift_unsigned
+ * | expr_lshift_rshift_rshift_unsigned
+ * */
+l2_ast_node *l2_ast_parse_expr_gt_lt_ge_le() {
+    static const l2_token_type oprs[] = { L2_TOKEN_GREAT_THAN, L2_TOKEN_LESS_THAN, L2_TOKEN_GREAT_EQUAL_THAN, L2_TOKEN_LESS_EQUAL_THAN };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_lshift_rshift_rshift_unsigned, oprs, 4);
+}
+
+/* expr_eq_ne ->
+ * | expr_eq_ne == expr_gt_lt_ge_le
+ * | expr_eq_ne != expr_gt_lt_ge_le
+ * | expr_gt_lt_ge_le
+ * */
+l2_ast_node *l2_ast_parse_expr_eq_ne() {
+    static const l2_token_type oprs[] = { L2_TOKEN_EQUAL, L2_TOKEN_NOT_EQUAL };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_gt_lt_ge_le, oprs, 2);
+}
+
+/* expr_bit_and ->
+ * | expr_bit_and & expr_eq_ne
+ * | expr_eq_ne
+ * */
+l2_ast_node *l2_ast_parse_expr_bit_and() {
+    static const l2_token_type oprs[] = { L2_TOKEN_BIT_AND };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_eq_ne, oprs, 1);
+}
+
+/* expr_bit_xor ->
+ * | expr_bit_xor ^ expr_bit_and
+ * | expr_bit_and
+ * */
+l2_ast_node *l2_ast_parse_expr_bit_xor() {
+    static const l2_token_type oprs[] = { L2_TOKEN_BIT_XOR };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_bit_and, oprs, 1);
+}
+
+/* expr_bit_or ->
+ * | expr_bit_or | expr_bit_xor
+ * | expr_bit_xor
+ * */
+l2_ast_node *l2_ast_parse_expr_bit_or() {
+    static const l2_token_type oprs[] = { L2_TOKEN_BIT_OR };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_bit_xor, oprs, 1);
+}
+
+/* expr_logic_and ->
+ * | expr_logic_and && expr_bit_or
+ * | expr_bit_or
+ * */
+l2_ast_node *l2_ast_parse_expr_logic_and() {
+    static const l2_token_type oprs[] = { L2_TOKEN_LOGIC_AND };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_bit_or, oprs, 1);
+}
+
+/* expr_logic_or ->
+ * | expr_logic_or || expr_logic_and
+ * | expr_logic_and
+ * */
+l2_ast_node *l2_ast_parse_expr_logic_or() {
+    static const l2_token_type oprs[] = { L2_TOKEN_LOGIC_OR };
+    return l2_ast_parse_expr_dualistic(l2_ast_parse_expr_logic_and, oprs, 1);
+}
+
+/* expr_condition ->
+ * | expr_logic_or ? expr : expr_condition
+ * | expr_logic_or
+ * */
+l2_ast_node *l2_ast_parse_expr_condition() {
+    l2_ast_node *first_p, *node_p;
+
+    first_p = l2_ast_parse_expr_logic_or();
+    if (!first_p) return L2_NULL_PTR;
+
+    _if_type (L2_TOKEN_QM)
+    {
+        node_p = l2_ast_node_new(L2_AST_EXPR_CONDITION, l2_parse_token_current());
+        node_p->u.branch.cond_p = first_p;
+        node_p->u.branch.then_p = l2_ast_parse_expr_required();
+
+        _if_type (L2_TOKEN_COLON)
+        {
+            node_p->u.branch.else_p = l2_ast_parse_expr_condition();
+
+            _if (node_p->u.branch.else_p) {
+
+            } _throw_unexpected_token
+
+        } _throw_missing_colon
+
+        return node_p;
+    }
+    _else
+    {
+        return first_p;
+    }
+}
+
+/* real_param_list ->
+ * | expr_assign real_param_list1
+ * | nil
+ *
+ * real_param_list1 ->
+ * | , expr_assign real_param_list1
+ * | nil
+ * */
+l2_ast_node *l2_ast_parse_real_param_list(int *args_count_p) {
+    l2_ast_node *head_p, *tail_p, *arg_p;
+
+    *args_count_p = 0;
+
+    head_p = l2_ast_parse_expr_assign();
+    if (!head_p) return L2_NULL_PTR;
+
+    *args_count_p = 1;
+    tail_p = head_p;
+
+    while (l2_parse_probe_next_token_by_type(L2_TOKEN_COMMA)) {
+        l2_parse_token_forward();
+
+        arg_p = l2_ast_parse_expr_assign();
+
+        _if (arg_p) {
+
+        } _throw_unexpected_token
+
+        tail_p->next_p = arg_p;
+        tail_p = arg_p;
+        *args_count_p += 1;
+    }
+
+    return head_p;
+}
+
+/* expr_single ->
+ * | ! expr_single
+ * | ~ expr_single
+ * | - expr_single
+ * | expr_atom
+ * */
+l2_ast_node *l2_ast_parse_expr_single() {
+    l2_ast_node *node_p;
+    l2_token *opr_p;
+
+    l2_parse_token_forward();
+    opr_p = l2_parse_token_current();
+
+    switch (opr_p->type) {
+        case L2_TOKEN_LOGIC_NOT: /* ! */
+        case L2_TOKEN_BIT_NOT: /* ~ */
+        case L2_TOKEN_SUB: /* - */
+            node_p = l2_ast_node_new(L2_AST_EXPR_UNARY, opr_p);
+            node_p->u.unary.opr = opr_p->type;
+            node_p->u.unary.operand_p = l2_ast_parse_expr_single();
+
+            _if (node_p->u.unary.operand_p) {
+
+            } _throw_unexpected_token
+
+            return node_p;
+
+        default:
+            l2_parse_token_back();
+    }
+
+    /* expr_atom ->
+     * | ( expr )
+     * | id
+     * | id ( real_param_list )
+     * | integer_literal
+     * | real_literal
+     * | keyword: true / false
+     * | nil ( returns null )
+     * */
+    _if_type (L2_TOKEN_LP)
+    {
+        node_p = l2_ast_parse_expr_required();
+
+        _if_type (L2_TOKEN_RP)
+        {
+            /* absorb ')' */
+        } _throw_missing_rp
+    }
+    _elif_type (L2_TOKEN_IDENTIFIER) /* id */
+    {
+        l2_token id = *l2_parse_token_current(); /* copied before probing the next token */
+
+        _if_type (L2_TOKEN_LP) /* '(' */
+        {
+            node_p = l2_ast_node_new(L2_AST_EXPR_CALL, &id);
+            node_p->u.call.id = id.u.id.str_p;
+            node_p->u.call.args_p = l2_ast_parse_real_param_list(&node_p->u.call.args_count);
+
+            _if_type (L2_TOKEN_RP)
+            {
+                /* absorb ')' */
+            } _throw_missing_rp
+        }
+        _else /* pure id */
+        {
+            node_p = l2_ast_node_new(L2_AST_EXPR_IDENTIFIER, &id);
+            node_p->u.ref.id = id.u.id.str_p;
+        }
+    }
+    _elif_type (L2_TOKEN_INTEGER_LITERAL)
+    {
+        node_p = l2_ast_node_new(L2_AST_EXPR_INTEGER, l2_parse_token_current());
+        node_p->u.integer = l2_parse_token_current()->u.integer;
+    }
+    _elif_type (L2_TOKEN_REAL_LITERAL)
+    {
+        node_p = l2_ast_node_new(L2_AST_EXPR_REAL, l2_parse_token_current());
+        node_p->u.real = l2_parse_token_current()->u.real;
+    }
+    _elif_keyword (L2_KW_TRUE) /* "true" */
+    {
+        node_p = l2_ast_node_new(L2_AST_EXPR_BOOL, l2_parse_token_current());
+        node_p->u.bool = L2_TRUE;
+    }
+    _elif_keyword (L2_KW_FALSE) /* "false" */
+    {
+        node_p = l2_ast_node_new(L2_AST_EXPR_BOOL, l2_parse_token_current());
+        node_p->u.bool = L2_FALSE;
+    }
+    _else
+    {
+        node_p = L2_NULL_PTR;
+    }
+
+    return node_p;
+}
@@ -0,0 +1,171 @@
+#ifndef _L2_AST_H_
+#define _L2_AST_H_
+
+#include "../l2_tpl/l2_common_type.h"
+#include "l2_token_stream.h"
+
+#define L2_AST_CHUNK_NODES_COUNT 256 /* the count of nodes in each chunk */
+#define L2_AST_ADDR_UNRESOLVED (-1) /* the hops of identifier which could only be looked up by name at run time */
+#define L2_AST_SLOT_REDEFINED (-1) /* the slot of definition whose identifier has been defined before in the same scope */
+
+typedef enum _l2_ast_node_type {
+    /* stmt */
+    L2_AST_STMT_BLOCK, /* { stmts } */
+    L2_AST_STMT_PROCEDURE, /* proc id ( formal_param_list ) { stmts } */
+    L2_AST_STMT_WHILE, /* while ( expr ) { stmts } */
+    L2_AST_STMT_DO_WHILE, /* do { stmts } while ( expr ) ; */
+    L2_AST_STMT_FOR, /* for ( expr ; expr ; expr ) { stmts } */
+    L2_AST_STMT_BREAK, /* break ; */
+    L2_AST_STMT_CONTINUE, /* continue ; */
+    L2_AST_STMT_RETURN, /* return ; | return expr ; */
+    L2_AST_STMT_IF, /* if ( expr ) { stmts } stmt_elif */
+    L2_AST_STMT_VAR, /* var id stmt_var_def_list1 ; */
+    L2_AST_STMT_EMPTY, /* ; */
+    L2_AST_STMT_EXPR, /* expr ; */
+    L2_AST_STMT_EVAL, /* eval expr ; */
+
+    /* expr */
+    L2_AST_EXPR_COMMA, /* expr_comma , expr_assign */
+    L2_AST_EXPR_ASSIGN, /* id = expr_assign | id += expr_assign | ... */
+    L2_AST_EXPR_CONDITION, /* expr_logic_or ? expr : expr_condition */
+    L2_AST_EXPR_BINARY, /* expr || expr | expr + expr | ... */
+    L2_AST_EXPR_UNARY, /* ! expr_single | ~ expr_single | - expr_single */
+    L2_AST_EXPR_IDENTIFIER, /* id */
+    L2_AST_EXPR_CALL, /* id ( real_param_list ) */
+    L2_AST_EXPR_INTEGER, /* integer_literal */
+    L2_AST_EXPR_REAL, /* real_literal */
+    L2_AST_EXPR_BOOL, /* true | false */
+
+    /* the element of var definition list and formal parameter list */
+    L2_AST_VAR_DEF /* id | id = expr_assign */
+
+}l2_ast_node_type;
+
+/* the lexical address of identifier, which is bound by resolver */
+typedef struct _l2_ast_addr {
+    int hops; /* the count of upper scopes to go through from the current scope */
+    int slot; /* the index of symbol in the slots of that scope */
+}l2_ast_addr;
+
+typedef struct _l2_ast_node {
+    l2_ast_node_type type;
+    int line; /* the position of the token which the node begins with, using for error report */
+    int col;
+    boolean has_call; /* the expr contains calls, which is evaluated by the tasks of ast engine instead of recursion, set by resolver */
+    struct _l2_ast_node *next_p; /* next node in stmts, var definition list and parameter list */
+    union {
+        struct {
+            struct _l2_ast_node *stmts_p;
+        }block;
+
+        struct {
+            char *id;
+            int slot; /* the slot of procedure symbol in the scope of definition */
+            struct _l2_ast_node *params_p; /* list of L2_AST_VAR_DEF without initialization */
+            int params_count;
+            struct _l2_ast_node *body_p; /* stmts */
+        }procedure;
+
+        struct { /* while and do-while */
+            struct _l2_ast_node *cond_p;
+            struct _l2_ast_node *body_p;
+        }loop;
+
+        struct {
+            struct _l2_ast_node *init_p; /* L2_AST_STMT_VAR, L2_AST_STMT_EXPR or null */
+            struct _l2_ast_node *cond_p; /* null means true */
+            struct _l2_ast_node *step_p; /* nullable */
+            struct _l2_ast_node *body_p;
+        }for_loop;
+
+        struct { /* if-elif-else and condition expr */
+            struct _l2_ast_node *cond_p;
+            struct _l2_ast_node *then_p; /* stmts ( if ) or expr ( condition expr ) */
+            struct _l2_ast_node *else_p; /* L2_AST_STMT_IF ( elif ), L2_AST_STMT_BLOCK ( else ), expr, or null */
+        }branch;
+
+        struct { /* return, eval, and expr stmt */
+            struct _l2_ast_node *expr_p; /* nullable in return stmt */
+        }stmt_expr;
+
+        struct {
+            struct _l2_ast_node *defs_p; /* list of L2_AST_VAR_DEF */
+        }var;
+
+        struct {
+            char *id;
+            int slot;
+            struct _l2_ast_node *init_p; /* nullable */
+        }var_def;
+
+        struct {
+            l2_token_type opr;
+            char *id;
+            int id_line; /* the position of id, the position of node is the operator */
+            int id_col;
+            l2_ast_addr addr;
+            struct _l2_ast_node *right_p;
+        }assign;
+
+        struct {
+            l2_token_type opr;
+            struct _l2_ast_node *left_p;
+            struct _l2_ast_node *right_p;
+        }binary;
+
+        struct {
+            l2_token_type opr;
+            struct _l2_ast_node *operand_p;
+        }unary;
+
+        struct {
+            char *id;
+            l2_ast_addr addr;
+            struct _l2_ast_node *args_p; /* list of expr */
+            int args_count;
+        }call;
+
+        struct {
+            char *id;
+            l2_ast_addr addr;
+        }ref;
+
+        int64_t integer;
+        double real;
+        boolean bool;
+    }u;
+}l2_ast_node;
+
+typedef struct _l2_ast_chunk {
+    struct _l2_ast_chunk *next_p;
+    int used;
+    l2_ast_node nodes[L2_AST_CHUNK_NODES_COUNT];
+}l2_ast_chunk;
+
+typedef struct _l2_ast {
+    l2_ast_chunk *chunk_p; /* all of the nodes live in chunks until the ast is destroyed */
+    int loop_level; /* the count of loops which enclose the current parsing position ( inside current procedure ) */
+    int procedure_level; /* the count of procedures which enclose the current parsing position */
+    struct _l2_ast_resolve_scope *global_scope_p; /* the names resolved in global scope, kept for the following stmts of repl */
+    int procedures_count; /* the count of procedure definitions parsed, which are referred by symbols after the stmts executed */
+}l2_ast;
+
+/* the position of allocation in chunks, the nodes allocated after it could be released by rolling back to it */
+typedef struct _l2_ast_mark {
+    l2_ast_chunk *chunk_p;
+    int used;
+    int procedures_count;
+}l2_ast_mark;
+
+l2_ast *l2_ast_create();
+void l2_ast_destroy(l2_ast *ast_p);
+l2_ast_mark l2_ast_get_mark();
+boolean l2_ast_release_since(l2_ast_mark *mark_p);
+
+l2_ast_node *l2_ast_parse_program();
+l2_ast_node *l2_ast_parse_stmt();
+l2_ast_node *l2_ast_parse_expr();
+
+char *l2_ast_str_opr(l2_token_type type);
+
+#endif
@@ -0,0 +1,1140 @@
+#include "l2_ast_eval.h"
+#include "l2_ast_resolve.h"
+#include "l2_symbol_table.h"
+#include "../l2_drv/l2_error.h"
+
+extern l2_parser *g_parser_p;
+
+/* the type string of operand, using for error report */
+char *l2_ast_eval_str_val_type(l2_expr_val_type val_type) {
+    switch (val_type) {
+        case L2_EXPR_VAL_TYPE_INTEGER: return "integer";
+        case L2_EXPR_VAL_TYPE_REAL: return "real";
+        case L2_EXPR_VAL_TYPE_BOOL: return "bool";
+        default: return "";
+    }
+}
+
+/* the description of incompatible operation between two types, using for error report */
+char *l2_ast_eval_str_between_val_types(l2_expr_val_type left_val_type, l2_expr_val_type right_val_type) {
+    static char *between_strs[3][3] = {
+            { "在整数型与整数型之间", "在整数型与实数型之间", "在整数型与布尔型之间" },
+            { "在实数型与整数型之间", "在实数型与实数型之间", "在实数型与布尔型之间" },
+            { "在布尔型与整数型之间", "在布尔型与实数型之间", "在布尔型与布尔型之间" }
+    };
+    return between_strs[left_val_type - L2_EXPR_VAL_TYPE_INTEGER][right_val_type - L2_EXPR_VAL_TYPE_INTEGER];
+}
+
+/* the operand of operators must be integer, real or bool */
+boolean l2_ast_eval_is_operand(l2_expr_info *expr_info_p) {
+    switch (expr_info_p->val_type) {
+        case L2_EXPR_VAL_TYPE_INTEGER:
+        case L2_EXPR_VAL_TYPE_REAL:
+        case L2_EXPR_VAL_TYPE_BOOL:
+            return L2_TRUE;
+
+        default:
+            return L2_FALSE;
+    }
+}
+
+/* store the value of expr into symbol, returns false if the expr has no value could be stored */
+boolean l2_ast_eval_set_symbol(l2_symbol *symbol_p, l2_expr_info *expr_info_p) {
+    switch (expr_info_p->val_type) {
+        case L2_EXPR_VAL_TYPE_INTEGER:
+            symbol_p->type = L2_SYMBOL_TYPE_INTEGER;
+            symbol_p->u.integer = expr_info_p->val.integer;
+            return L2_TRUE;
+
+        case L2_EXPR_VAL_TYPE_REAL:
+            symbol_p->type = L2_SYMBOL_TYPE_REAL;
+            symbol_p->u.real = expr_info_p->val.real;
+            return L2_TRUE;
+
+        case L2_EXPR_VAL_TYPE_BOOL:
+            symbol_p->type = L2_SYMBOL_TYPE_BOOL;
+            symbol_p->u.bool = expr_info_p->val.bool;
+            return L2_TRUE;
+
+        case L2_EXPR_VAL_TYPE_PROCEDURE:
+            symbol_p->type = L2_SYMBOL_TYPE_PROCEDURE;
+            symbol_p->u.procedure = expr_info_p->val.procedure;
+            return L2_TRUE;
+
+        default:
+            return L2_FALSE;
+    }
+}
+
+/* package the value of symbol into expr info, returns the expr info without value if the symbol has no value */
+l2_expr_info l2_ast_eval_get_symbol(l2_symbol *symbol_p) {
+    l2_expr_info res_expr_info;
+
+    switch (symbol_p->type) {
+        case L2_SYMBOL_TYPE_INTEGER:
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_INTEGER;
+            res_expr_info.val.integer = symbol_p->u.integer;
+            break;
+
+        case L2_SYMBOL_TYPE_REAL:
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_REAL;
+            res_expr_info.val.real = symbol_p->u.real;
+            break;
+
+        case L2_SYMBOL_TYPE_BOOL:
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_BOOL;
+            res_expr_info.val.bool = symbol_p->u.bool;
+            break;
+
+        case L2_SYMBOL_TYPE_PROCEDURE:
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_PROCEDURE;
+            res_expr_info.val.procedure = symbol_p->u.procedure;
+            break;
+
+        default:
+            res_expr_info.val_type = L2_EXPR_VAL_NO_VAL;
+    }
+
+    return res_expr_info;
+}
+
+/* find the symbol of identifier by the address bound by resolver, or by name if it is unresolved */
+l2_symbol_node *l2_ast_eval_get_symbol_node(l2_scope *scope_p, char *id, l2_ast_addr addr) {
+    int hops;
+
+    if (addr.hops == L2_AST_ADDR_UNRESOLVED)
+        return l2_eval_get_symbol_node(scope_p, id);
+
+    for (hops = addr.hops; hops > 0; hops--)
+        scope_p = scope_p->upper_p;
+
+    return scope_p->symbol_table_p->slots_p[addr.slot];
+}
+
+/* the arithmetic shared by dualistic operators and compound assignment operators,
+ * returns false if the types of operands are incompatible with the operator
+ * */
+boolean l2_ast_eval_arith(l2_token_type opr, l2_expr_info *left_p, l2_expr_info *right_p, l2_expr_info *res_p, int err_line, int err_col) {
+    double left_real, right_real;
+
+    if (left_p->val_type == L2_EXPR_VAL_TYPE_INTEGER && right_p->val_type == L2_EXPR_VAL_TYPE_INTEGER) {
+        int64_t left_integer = left_p->val.integer, right_integer = right_p->val.integer;
+        res_p->val_type = L2_EXPR_VAL_TYPE_INTEGER;
+
+        switch (opr) {
+            case L2_TOKEN_PLUS: res_p->val.integer = left_integer + right_integer; break;
+            case L2_TOKEN_SUB: res_p->val.integer = left_integer - right_integer; break;
+            case L2_TOKEN_MUL: res_p->val.integer = left_integer * right_integer; break;
+
+            case L2_TOKEN_DIV:
+                if (!right_integer) l2_parsing_error(L2_PARSING_ERROR_DIVIDE_BY_ZERO, err_line, err_col);
+                res_p->val.integer = left_integer / right_integer;
+                break;
+
+            case L2_TOKEN_MOD:
+                if (!right_integer) l2_parsing_error(L2_PARSING_ERROR_DIVIDE_BY_ZERO, err_line, err_col);
+                res_p->val.integer = left_integer % right_integer;
+                break;
+
+            case L2_TOKEN_LSHIFT: res_p->val.integer = left_integer << right_integer; break;
+            case L2_TOKEN_RSHIFT: res_p->val.integer = left_integer >> right_integer; break;
+            case L2_TOKEN_RSHIFT_UNSIGNED: res_p->val.integer = (int64_t)((uint64_t)left_integer >> right_integer); break;
+            case L2_TOKEN_BIT_AND: res_p->val.integer = left_integer & right_integer; break;
+            case L2_TOKEN_BIT_XOR: res_p->val.integer = left_integer ^ right_integer; break;
+            case L2_TOKEN_BIT_OR: res_p->val.integer = left_integer | right_integer; break;
+
+            default:
+                return L2_FALSE;
+        }
+        return L2_TRUE;
+    }
+
+    /* the operators below could operate on real */
+    switch (opr) {
+        case L2_TOKEN_PLUS:
+        case L2_TOKEN_SUB:
+        case L2_TOKEN_MUL:
+        case L2_TOKEN_DIV:
+            break;
+
+        default:
+            return L2_FALSE;
+    }
+
+    if (left_p->val_type == L2_EXPR_VAL_TYPE_INTEGER) left_real = (double)left_p->val.integer;
+    else if (left_p->val_type == L2_EXPR_VAL_TYPE_REAL) left_real = left_p->val.real;
+    else return L2_FALSE;
+
+    if (right_p->val_type == L2_EXPR_VAL_TYPE_INTEGER) right_real = (double)right_p->val.integer;
+    else if (right_p->val_type == L2_EXPR_VAL_TYPE_REAL) right_real = right_p->val.real;
+    else return L2_FALSE;
+
+    res_p->val_type = L2_EXPR_VAL_TYPE_REAL;
+    switch (opr) {
+        case L2_TOKEN_PLUS: res_p->val.real = left_real + right_real; break;
+        case L2_TOKEN_SUB: res_p->val.real = left_real - right_real; break;
+        case L2_TOKEN_MUL: res_p->val.real = left_real * right_real; break;
+        default: res_p->val.real = left_real / right_real;
+    }
+    return L2_TRUE;
+}
+
+/* the comparison of operands, returns false if the types of operands are incompatible with the operator */
+boolean l2_ast_eval_compare(l2_token_type opr, l2_expr_info *left_p, l2_expr_info *right_p, boolean *res_p) {
+    double left_real, right_real;
+
+    if (left_p->val_type == L2_EXPR_VAL_TYPE_BOOL || right_p->val_type == L2_EXPR_VAL_TYPE_BOOL) {
+        if (left_p->val_type != right_p->val_type) return L2_FALSE;
+
+        switch (opr) {
+            case L2_TOKEN_EQUAL: *res_p = (left_p->val.bool == right_p->val.bool); return L2_TRUE;
+            case L2_TOKEN_NOT_EQUAL: *res_p = (left_p->val.bool != right_p->val.bool); return L2_TRUE;
+            default: return L2_FALSE;
+        }
+    }
+
+    if (left_p->val_type == L2_EXPR_VAL_TYPE_INTEGER && right_p->val_type == L2_EXPR_VAL_TYPE_INTEGER) {
+        int64_t left_integer = left_p->val.integer, right_integer = right_p->val.integer;
+
+        switch (opr) {
+            case L2_TOKEN_EQUAL: *res_p = (left_integer == right_integer); break;
+            case L2_TOKEN_NOT_EQUAL: *res_p = (left_integer != right_integer); break;
+            case L2_TOKEN_GREAT_THAN: *res_p = (left_integer > right_integer); break;
+            case L2_TOKEN_GREAT_EQUAL_THAN: *res_p = (left_integer >= right_integer); break;
+            case L2_TOKEN_LESS_THAN: *res_p = (left_integer < right_integer); break;
+            default: *res_p = (left_integer <= right_integer);
+        }
+        return L2_TRUE;
+    }
+
+    left_real = left_p->val_type == L2_EXPR_VAL_TYPE_INTEGER ? (double)left_p->val.integer : left_p->val.real;
+    right_real = right_p->val_type == L2_EXPR_VAL_TYPE_INTEGER ? (double)right_p->val.integer : right_p->val.real;
+
+    switch (opr) {
+        case L2_TOKEN_EQUAL: *res_p = (left_real == right_real); break;
+        case L2_TOKEN_NOT_EQUAL: *res_p = (left_real != right_real); break;
+        case L2_TOKEN_GREAT_THAN: *res_p = (left_real > right_real); break;
+        case L2_TOKEN_GREAT_EQUAL_THAN: *res_p = (left_real >= right_real); break;
+        case L2_TOKEN_LESS_THAN: *res_p = (left_real < right_real); break;
+        default: *res_p = (left_real <= right_real);
+    }
+    return L2_TRUE;
+}
+
+/* the dualistic operator which the compound assignment operator performs */
+l2_token_type l2_ast_eval_compound_assign_opr(l2_token_type opr) {
+    switch (opr) {
+        case L2_TOKEN_PLUS_ASSIGN: return L2_TOKEN_PLUS;
+        case L2_TOKEN_SUB_ASSIGN: return L2_TOKEN_SUB;
+        case L2_TOKEN_MUL_ASSIGN: return L2_TOKEN_MUL;
+        case L2_TOKEN_DIV_ASSIGN: return L2_TOKEN_DIV;
+        case L2_TOKEN_MOD_ASSIGN: return L2_TOKEN_MOD;
+        case L2_TOKEN_RSHIFT_ASSIGN: return L2_TOKEN_RSHIFT;
+        case L2_TOKEN_RSHIFT_UNSIGNED_ASSIGN: return L2_TOKEN_RSHIFT_UNSIGNED;
+        case L2_TOKEN_LSHIFT_ASSIGN: return L2_TOKEN_LSHIFT;
+        case L2_TOKEN_BIT_AND_ASSIGN: return L2_TOKEN_BIT_AND;
+        case L2_TOKEN_BIT_XOR_ASSIGN: return L2_TOKEN_BIT_XOR;
+        case L2_TOKEN_BIT_OR_ASSIGN: return L2_TOKEN_BIT_OR;
+        default:
+            l2_internal_error(L2_INTERNAL_ERROR_UNREACHABLE_CODE, "无效的复合赋值运算符");
+    }
+}
+
+/* perform the assignment with the value of right expr */
+l2_expr_info l2_ast_eval_assign(l2_ast_node *expr_p, l2_scope *scope_p, l2_expr_info right_expr_info) {
+    l2_expr_info left_expr_info, res_expr_info;
+    l2_symbol_node *symbol_node_p;
+    l2_token_type opr = expr_p->u.assign.opr;
+
+    symbol_node_p = l2_ast_eval_get_symbol_node(scope_p, expr_p->u.assign.id, expr_p->u.assign.addr);
+
+    if (opr == L2_TOKEN_ASSIGN) { /* = */
+        switch (right_expr_info.val_type) {
+            case L2_EXPR_VAL_TYPE_INTEGER:
+            case L2_EXPR_VAL_TYPE_REAL:
+            case L2_EXPR_VAL_TYPE_BOOL:
+            case L2_EXPR_VAL_TYPE_PROCEDURE:
+                break;
+
+            default:
+                l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE, expr_p->line, expr_p->col);
+        }
+
+        if (!symbol_node_p)
+            l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, expr_p->u.assign.id_line, expr_p->u.assign.id_col, expr_p->u.assign.id);
+
+        l2_ast_eval_set_symbol(&symbol_node_p->symbol, &right_expr_info);
+
+        /* return the right expr info */
+        return right_expr_info;
+    }
+
+    /* compound assignment */
+    if (!symbol_node_p)
+        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, expr_p->u.assign.id_line, expr_p->u.assign.id_col, expr_p->u.assign.id);
+
+    if (!l2_ast_eval_is_operand(&right_expr_info))
+        l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE, expr_p->line, expr_p->col);
+
+    left_expr_info = l2_ast_eval_get_symbol(&symbol_node_p->symbol);
+    if (!l2_ast_eval_is_operand(&left_expr_info))
+        l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, expr_p->u.assign.id_line, expr_p->u.assign.id_col);
+
+    if (!l2_ast_eval_arith(l2_ast_eval_compound_assign_opr(opr), &left_expr_info, &right_expr_info, &res_expr_info, expr_p->line, expr_p->col))
+        l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, expr_p->line, expr_p->col, l2_ast_str_opr(opr),
+                         l2_ast_eval_str_between_val_types(left_expr_info.val_type, right_expr_info.val_type));
+
+    l2_ast_eval_set_symbol(&symbol_node_p->symbol, &res_expr_info);
+    return res_expr_info;
+}
+
+/* whether the left value decides the result of && or ||, so that the right side is not evaluated */
+boolean l2_ast_eval_short_circuit(l2_ast_node *expr_p, l2_expr_info left_expr_info) {
+    l2_token_type opr = expr_p->u.binary.opr;
+
+    if (opr != L2_TOKEN_LOGIC_OR && opr != L2_TOKEN_LOGIC_AND)
+        return L2_FALSE;
+
+    if (left_expr_info.val_type != L2_EXPR_VAL_TYPE_BOOL)
+        l2_parsing_error(L2_PARSING_ERROR_LEFT_SIDE_OF_OPERATOR_MUST_BE_A_BOOL_VALUE, expr_p->line, expr_p->col, l2_ast_str_opr(opr));
+
+    return left_expr_info.val.bool == (opr == L2_TOKEN_LOGIC_OR);
+}
+
+/* perform the dualistic operation with the values of both sides */
+l2_expr_info l2_ast_eval_dualistic(l2_ast_node *expr_p, l2_expr_info left_expr_info, l2_expr_info right_expr_info) {
+    l2_expr_info res_expr_info;
+    l2_token_type opr = expr_p->u.binary.opr;
+    boolean cmp_res;
+
+    switch (opr) {
+        case L2_TOKEN_LOGIC_OR: /* || */
+        case L2_TOKEN_LOGIC_AND: /* && */
+            if (left_expr_info.val_type != L2_EXPR_VAL_TYPE_BOOL)
+                l2_parsing_error(L2_PARSING_ERROR_LEFT_SIDE_OF_OPERATOR_MUST_BE_A_BOOL_VALUE, expr_p->line, expr_p->col, l2_ast_str_opr(opr));
+
+            if (right_expr_info.val_type != L2_EXPR_VAL_TYPE_BOOL)
+                l2_parsing_error(L2_PARSING_ERROR_RIGHT_SIDE_OF_OPERATOR_MUST_BE_A_BOOL_VALUE, expr_p->line, expr_p->col, l2_ast_str_opr(opr));
+
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_BOOL;
+            res_expr_info.val.bool = opr == L2_TOKEN_LOGIC_OR
+                    ? (left_expr_info.val.bool || right_expr_info.val.bool)
+                    : (left_expr_info.val.bool && right_expr_info.val.bool);
+            return res_expr_info;
+
+        case L2_TOKEN_BIT_OR: /* | */
+        case L2_TOKEN_BIT_XOR: /* ^ */
+        case L2_TOKEN_BIT_AND: /* & */
+            if (left_expr_info.val_type != L2_EXPR_VAL_TYPE_INTEGER)
+                l2_parsing_error(L2_PARSING_ERROR_LEFT_SIDE_OF_OPERATOR_MUST_BE_A_INTEGER_VALUE, expr_p->line, expr_p->col, l2_ast_str_opr(opr));
+
+            if (right_expr_info.val_type != L2_EXPR_VAL_TYPE_INTEGER)
+                l2_parsing_error(L2_PARSING_ERROR_RIGHT_SIDE_OF_OPERATOR_MUST_BE_A_INTEGER_VALUE, expr_p->line, expr_p->col, l2_ast_str_opr(opr));
+            break;
+
+        default:
+            break;
+    }
+
+    if (!l2_ast_eval_is_operand(&left_expr_info) || !l2_ast_eval_is_operand(&right_expr_info))
+        l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE, expr_p->line, expr_p->col);
+
+    switch (opr) {
+        case L2_TOKEN_EQUAL: /* == */
+        case L2_TOKEN_NOT_EQUAL: /* != */
+        case L2_TOKEN_GREAT_THAN: /* > */
+        case L2_TOKEN_GREAT_EQUAL_THAN: /* >= */
+        case L2_TOKEN_LESS_THAN: /* < */
+        case L2_TOKEN_LESS_EQUAL_THAN: /* <= */
+            if (!l2_ast_eval_compare(opr, &left_expr_info, &right_expr_info, &cmp_res))
+                break;
+
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_BOOL;
+            res_expr_info.val.bool = cmp_res;
+            return res_expr_info;
+
+        default:
+            if (!l2_ast_eval_arith(opr, &left_expr_info, &right_expr_info, &res_expr_info, expr_p->line, expr_p->col))
+                break;
+
+            return res_expr_info;
+    }
+
+    l2_parsing_error(L2_PARSING_ERROR_DUALISTIC_OPERATOR_CONTAINS_INCOMPATIBLE_TYPE, expr_p->line, expr_p->col, l2_ast_str_opr(opr),
+                     l2_ast_eval_str_val_type(left_expr_info.val_type), l2_ast_eval_str_val_type(right_expr_info.val_type));
+}
+
+/* perform the unitary operation with the value of operand */
+l2_expr_info l2_ast_eval_unitary(l2_ast_node *expr_p, l2_expr_info right_expr_info) {
+    l2_expr_info res_expr_info;
+    l2_token_type opr = expr_p->u.unary.opr;
+
+    if (!l2_ast_eval_is_operand(&right_expr_info))
+        l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE, expr_p->line, expr_p->col);
+
+    res_expr_info.val_type = right_expr_info.val_type;
+    switch (opr) {
+        case L2_TOKEN_LOGIC_NOT: /* ! */
+            if (right_expr_info.val_type != L2_EXPR_VAL_TYPE_BOOL) break;
+            res_expr_info.val.bool = !(right_expr_info.val.bool);
+            return res_expr_info;
+
+        case L2_TOKEN_BIT_NOT: /* ~ */
+            if (right_expr_info.val_type != L2_EXPR_VAL_TYPE_INTEGER) break;
+            res_expr_info.val.integer = ~(right_expr_info.val.integer);
+            return res_expr_info;
+
+        default: /* - */
+            if (right_expr_info.val_type == L2_EXPR_VAL_TYPE_INTEGER) {
+                res_expr_info.val.integer = -(right_expr_info.val.integer);
+                return res_expr_info;
+
+            } else if (right_expr_info.val_type == L2_EXPR_VAL_TYPE_REAL) {
+                res_expr_info.val.real = -(right_expr_info.val.real);
+                return res_expr_info;
+            }
+    }
+
+    l2_parsing_error(L2_PARSING_ERROR_UNITARY_OPERATOR_CONTAINS_INCOMPATIBLE_TYPE, expr_p->line, expr_p->col, l2_ast_str_opr(opr),
+                     l2_ast_eval_str_val_type(right_expr_info.val_type));
+}
+
+/* find the procedure to be called, and check the count of parameters */
+l2_procedure l2_ast_eval_get_procedure(l2_ast_node *expr_p, l2_scope *scope_p) {
+    l2_symbol_node *symbol_node_p;
+    l2_ast_node *procedure_node_p;
+
+    symbol_node_p = l2_ast_eval_get_symbol_node(scope_p, expr_p->u.call.id, expr_p->u.call.addr);
+    if (!symbol_node_p)
+        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, expr_p->line, expr_p->col, expr_p->u.call.id);
+
+    /* judge the symbol type ( procedure ) */
+    if (symbol_node_p->symbol.type != L2_SYMBOL_TYPE_PROCEDURE)
+        l2_parsing_error(L2_PARSING_ERROR_SYMBOL_IS_NOT_PROCEDURE, expr_p->line, expr_p->col, expr_p->u.call.id);
+
+    procedure_node_p = symbol_node_p->symbol.u.procedure.ast_node_p;
+
+    if (expr_p->u.call.args_count > procedure_node_p->u.procedure.params_count)
+        l2_parsing_error(L2_PARSING_ERROR_TOO_MANY_PARAMETERS, expr_p->line, expr_p->col);
+
+    if (expr_p->u.call.args_count < procedure_node_p->u.procedure.params_count)
+        l2_parsing_error(L2_PARSING_ERROR_TOO_FEW_PARAMETERS, expr_p->line, expr_p->col);
+
+    return symbol_node_p->symbol.u.procedure;
+}
+
+/* bind the value of real parameter to the formal parameter in procedure scope */
+void l2_ast_eval_bind_param(l2_ast_node *param_p, l2_scope *procedure_scope_p, l2_expr_info arg_expr_info, int err_line, int err_col) {
+    l2_symbol symbol;
+
+    if (arg_expr_info.val_type == L2_EXPR_VAL_NO_VAL)
+        l2_parsing_error(L2_PARSING_ERROR_EXPR_RESULT_WITHOUT_VALUE, err_line, err_col);
+
+    symbol.symbol_name = param_p->u.var_def.id;
+    if (!l2_ast_eval_set_symbol(&symbol, &arg_expr_info))
+        l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE, err_line, err_col);
+
+    l2_symbol_table_define_symbol(procedure_scope_p, symbol);
+}
+
+/* create new procedure scope, and bind the values of real parameters to the formal parameters */
+l2_scope *l2_ast_eval_bind_params(l2_ast_node *expr_p, l2_procedure *procedure_p, l2_expr_info *args_p) {
+    l2_scope *procedure_scope_p;
+    l2_ast_node *arg_p, *param_p;
+
+    procedure_scope_p = l2_scope_create_procedure_scope(procedure_p->upper_scope_p, L2_SCOPE_CREATE_SUB_SCOPE);
+
+    for (arg_p = expr_p->u.call.args_p, param_p = procedure_p->ast_node_p->u.procedure.params_p;
+         arg_p; arg_p = arg_p->next_p, param_p = param_p->next_p, args_p++) {
+        l2_ast_eval_bind_param(param_p, procedure_scope_p, *args_p, arg_p->line, arg_p->col);
+    }
+
+    return procedure_scope_p;
+}
+
+/* read the value of identifier */
+l2_expr_info l2_ast_eval_identifier(l2_ast_node *expr_p, l2_scope *scope_p) {
+    l2_expr_info res_expr_info;
+    l2_symbol_node *symbol_node_p;
+
+    symbol_node_p = l2_ast_eval_get_symbol_node(scope_p, expr_p->u.ref.id, expr_p->u.ref.addr);
+    if (!symbol_node_p)
+        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, expr_p->line, expr_p->col, expr_p->u.ref.id);
+
+    res_expr_info = l2_ast_eval_get_symbol(&symbol_node_p->symbol);
+    if (res_expr_info.val_type == L2_EXPR_VAL_NO_VAL)
+        l2_parsing_error(L2_PARSING_ERROR_REFERENCE_SYMBOL_BEFORE_INITIALIZATION, expr_p->line, expr_p->col, expr_p->u.ref.id);
+
+    return res_expr_info;
+}
+
+/* evaluate the expr without calls by recursion */
+l2_expr_info l2_ast_eval_expr(l2_ast_node *expr_p, l2_scope *scope_p) {
+    l2_expr_info res_expr_info;
+
+    switch (expr_p->type) {
+        case L2_AST_EXPR_COMMA:
+            l2_ast_eval_expr(expr_p->u.binary.left_p, scope_p);
+            return l2_ast_eval_expr(expr_p->u.binary.right_p, scope_p);
+
+        case L2_AST_EXPR_ASSIGN:
+            return l2_ast_eval_assign(expr_p, scope_p, l2_ast_eval_expr(expr_p->u.assign.right_p, scope_p));
+
+        case L2_AST_EXPR_CONDITION:
+            res_expr_info = l2_ast_eval_expr(expr_p->u.branch.cond_p, scope_p);
+
+            if (res_expr_info.val_type != L2_EXPR_VAL_TYPE_BOOL)
+                l2_parsing_error(L2_PARSING_ERROR_EXPR_NOT_BOOL, expr_p->line, expr_p->col);
+
+            return l2_ast_eval_expr(res_expr_info.val.bool ? expr_p->u.branch.then_p : expr_p->u.branch.else_p, scope_p);
+
+        case L2_AST_EXPR_BINARY:
+            res_expr_info = l2_ast_eval_expr(expr_p->u.binary.left_p, scope_p);
+            if (l2_ast_eval_short_circuit(expr_p, res_expr_info))
+                return res_expr_info;
+
+            return l2_ast_eval_dualistic(expr_p, res_expr_info, l2_ast_eval_expr(expr_p->u.binary.right_p, scope_p));
+
+        case L2_AST_EXPR_UNARY:
+            return l2_ast_eval_unitary(expr_p, l2_ast_eval_expr(expr_p->u.unary.operand_p, scope_p));
+
+        case L2_AST_EXPR_IDENTIFIER:
+            return l2_ast_eval_identifier(expr_p, scope_p);
+
+        case L2_AST_EXPR_INTEGER:
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_INTEGER;
+            res_expr_info.val.integer = expr_p->u.integer;
+            return res_expr_info;
+
+        case L2_AST_EXPR_REAL:
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_REAL;
+            res_expr_info.val.real = expr_p->u.real;
+            return res_expr_info;
+
+        case L2_AST_EXPR_BOOL:
+            res_expr_info.val_type = L2_EXPR_VAL_TYPE_BOOL;
+            res_expr_info.val.bool = expr_p->u.bool;
+            return res_expr_info;
+
+        default: /* the call is evaluated by tasks */
+            l2_internal_error(L2_INTERNAL_ERROR_UNREACHABLE_CODE, "无效的表达式节点");
+    }
+}
+
+/* store the procedure information as a symbol into symbol table,
+ * entry_pos is only used by vm, which is the position of procedure body in bytecode
+ * */
+void l2_ast_eval_define_procedure(l2_ast_node *stmt_p, l2_scope *scope_p, int entry_pos) {
+    l2_symbol symbol;
+
+    if (stmt_p->u.procedure.slot == L2_AST_SLOT_REDEFINED)
+        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, stmt_p->line, stmt_p->col, stmt_p->u.procedure.id);
+
+    symbol.type = L2_SYMBOL_TYPE_PROCEDURE;
+    symbol.symbol_name = stmt_p->u.procedure.id;
+    symbol.u.procedure.entry_pos = entry_pos;
+    symbol.u.procedure.upper_scope_p = scope_p;
+    symbol.u.procedure.ast_node_p = stmt_p;
+    l2_symbol_table_define_symbol(scope_p, symbol);
+}
+
+/* allocate position for the identifier in symbol table, the redefinition has been found by resolver */
+void l2_ast_eval_define_var(l2_ast_node *def_p, l2_scope *scope_p) {
+    l2_symbol symbol;
+
+    if (def_p->u.var_def.slot == L2_AST_SLOT_REDEFINED)
+        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, def_p->line, def_p->col, def_p->u.var_def.id);
+
+    symbol.type = L2_SYMBOL_UNINITIALIZED;
+    symbol.symbol_name = def_p->u.var_def.id;
+    l2_symbol_table_define_symbol(scope_p, symbol);
+}
+
+/* initialize the variable which is defined in current scope */
+void l2_ast_eval_init_var(l2_ast_node *def_p, l2_scope *scope_p, l2_expr_info expr_info) {
+    if (expr_info.val_type == L2_EXPR_VAL_NO_VAL)
+        l2_parsing_error(L2_PARSING_ERROR_EXPR_RESULT_WITHOUT_VALUE, def_p->line, def_p->col);
+
+    if (!l2_ast_eval_set_symbol(&scope_p->symbol_table_p->slots_p[def_p->u.var_def.slot]->symbol, &expr_info))
+        l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE, def_p->line, def_p->col);
+}
+
+/* print the value of eval stmt */
+void l2_ast_eval_print(l2_ast_node *stmt_p, l2_expr_info expr_info) {
+    switch (expr_info.val_type) {
+        case L2_EXPR_VAL_TYPE_INTEGER:
+            fprintf(stdout, "%lld\n", (long long)expr_info.val.integer);
+            break;
+
+        case L2_EXPR_VAL_TYPE_REAL:
+            fprintf(stdout, "%lf\n", expr_info.val.real);
+            break;
+
+        case L2_EXPR_VAL_TYPE_BOOL:
+            fprintf(stdout, "%s\n", expr_info.val.bool ? "true" : "false");
+            break;
+
+        default:
+            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_EXPR_TYPE, stmt_p->line, stmt_p->col);
+    }
+}
+
+void l2_ast_eval_push_task(l2_ast_eval_machine *machine_p, l2_ast_eval_task_type type, l2_ast_node *node_p, l2_ast_node *cursor_p,
+                           l2_scope *scope_p, l2_scope *sub_scope_p) {
+    l2_ast_eval_task task;
+
+    task.type = type;
+    task.step = 0;
+    task.node_p = node_p;
+    task.cursor_p = cursor_p;
+    task.scope_p = scope_p;
+    task.sub_scope_p = sub_scope_p;
+    l2_ast_eval_task_stack_push_back(&machine_p->task_stack, task);
+}
+
+/* the task on the top is done, and the scope created for it is escaped */
+void l2_ast_eval_pop_task(l2_ast_eval_machine *machine_p) {
+    l2_ast_eval_task *task_p = l2_ast_eval_task_stack_pop(&machine_p->task_stack);
+
+    if (task_p->sub_scope_p)
+        l2_scope_escape_scope(task_p->sub_scope_p);
+}
+
+void l2_ast_eval_push_operand(l2_ast_eval_machine *machine_p, l2_expr_info expr_info) {
+    l2_expr_info_stack_push_back(&machine_p->operand_stack, expr_info);
+}
+
+/* the pushes and pops of tasks are balanced, so the operand stack is popped without checking */
+l2_expr_info l2_ast_eval_pop_operand(l2_ast_eval_machine *machine_p) {
+    return machine_p->operand_stack.stack_p[--machine_p->operand_stack.size];
+}
+
+/* the value of expr will be pushed onto operand stack, it is evaluated at once if there is no call inside,
+ * returns true if the task of expr is pushed, and the value is pushed after the task is done
+ * */
+boolean l2_ast_eval_push_expr(l2_ast_eval_machine *machine_p, l2_ast_node *expr_p, l2_scope *scope_p) {
+    if (expr_p->has_call) {
+        l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_EXPR, expr_p, L2_NULL_PTR, scope_p, L2_NULL_PTR);
+        return L2_TRUE;
+    }
+
+    l2_ast_eval_push_operand(machine_p, l2_ast_eval_expr(expr_p, scope_p));
+    return L2_FALSE;
+}
+
+void l2_ast_eval_step_stmt(l2_ast_eval_machine *machine_p, l2_ast_eval_task *task_p, l2_stmt_interrupt *irt_p);
+
+/* the stmt will be run by its task, step by step, the first step is taken at once */
+void l2_ast_eval_push_stmt(l2_ast_eval_machine *machine_p, l2_ast_node *stmt_p, l2_scope *scope_p, l2_stmt_interrupt *irt_p) {
+    l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_STMT, stmt_p, L2_NULL_PTR, scope_p, L2_NULL_PTR);
+    l2_ast_eval_step_stmt(machine_p, l2_ast_eval_task_stack_back(&machine_p->task_stack), irt_p);
+}
+
+/* the value of condition popped, it must be a bool value */
+boolean l2_ast_eval_pop_cond(l2_ast_eval_machine *machine_p, l2_ast_node *node_p) {
+    l2_expr_info expr_info = l2_ast_eval_pop_operand(machine_p);
+
+    if (expr_info.val_type != L2_EXPR_VAL_TYPE_BOOL)
+        l2_parsing_error(L2_PARSING_ERROR_EXPR_NOT_BOOL, node_p->line, node_p->col);
+
+    return expr_info.val.bool;
+}
+
+/* call the procedure, the values of real parameters are on the top of operand stack,
+ * the body task takes the place of the call on the top of task stack
+ * */
+void l2_ast_eval_call(l2_ast_eval_machine *machine_p, l2_ast_node *expr_p, l2_procedure *procedure_p, l2_scope *scope_p) {
+    l2_call_frame call_frame;
+
+    machine_p->operand_stack.size -= expr_p->u.call.args_count;
+    call_frame.procedure_scope_p = l2_ast_eval_bind_params(expr_p, procedure_p, machine_p->operand_stack.stack_p + machine_p->operand_stack.size);
+
+    call_frame.ret_pos = 0;
+    call_frame.ret_scope_p = scope_p;
+    l2_call_stack_push_frame(g_parser_p->call_stack_p, call_frame, expr_p->line, expr_p->col);
+
+    l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_BODY, procedure_p->ast_node_p, L2_NULL_PTR,
+                          call_frame.procedure_scope_p, call_frame.procedure_scope_p);
+}
+
+/* the procedure returns with the interrupt, or the callee of tail call runs in place of it with the same frame */
+void l2_ast_eval_return(l2_ast_eval_machine *machine_p, l2_ast_eval_task *task_p, l2_stmt_interrupt *irt_p) {
+    l2_expr_info res_expr_info;
+    l2_procedure procedure;
+    l2_ast_node *expr_p;
+
+    switch (irt_p->type) {
+        case L2_STMT_INTERRUPT_TAIL_CALL:
+            /* the values of real parameters are on the top of operand stack */
+            l2_scope_escape_scope(task_p->sub_scope_p);
+
+            procedure = irt_p->u.tail_call.procedure;
+            expr_p = irt_p->u.tail_call.expr_p;
+            machine_p->operand_stack.size -= expr_p->u.call.args_count;
+            task_p->sub_scope_p = l2_ast_eval_bind_params(expr_p, &procedure, machine_p->operand_stack.stack_p + machine_p->operand_stack.size);
+            l2_call_stack_reuse_frame(g_parser_p->call_stack_p, task_p->sub_scope_p);
+
+            task_p->node_p = procedure.ast_node_p;
+            task_p->scope_p = task_p->sub_scope_p;
+            task_p->step = 0;
+            irt_p->type = L2_STMT_NO_INTERRUPT;
+            return;
+
+        case L2_STMT_INTERRUPT_RETURN_WITH_VAL:
+            res_expr_info = irt_p->u.ret_expr_info;
+            break;
+
+        default: /* no return value */
+            res_expr_info.val_type = L2_EXPR_VAL_NO_VAL;
+    }
+
+    /* procedure execution complete */
+    l2_call_stack_pop_frame(g_parser_p->call_stack_p);
+    l2_ast_eval_pop_task(machine_p); /* escape from procedure scope */
+
+    l2_ast_eval_push_operand(machine_p, res_expr_info);
+    irt_p->type = L2_STMT_NO_INTERRUPT;
+}
+
+/* the interrupt is passed to the enclosing tasks, until it is consumed by a loop or procedure body */
+void l2_ast_eval_unwind(l2_ast_eval_machine *machine_p, l2_stmt_interrupt *irt_p) {
+    l2_ast_eval_task *task_p = l2_ast_eval_task_stack_back(&machine_p->task_stack);
+
+    if (task_p->type == L2_AST_EVAL_TASK_BODY) {
+        l2_ast_eval_return(machine_p, task_p, irt_p);
+        return;
+    }
+
+    if (task_p->type == L2_AST_EVAL_TASK_STMT
+        && (task_p->node_p->type == L2_AST_STMT_WHILE || task_p->node_p->type == L2_AST_STMT_DO_WHILE || task_p->node_p->type == L2_AST_STMT_FOR)) {
+        switch (irt_p->type) {
+            case L2_STMT_INTERRUPT_BREAK:
+                l2_ast_eval_pop_task(machine_p);
+                irt_p->type = L2_STMT_NO_INTERRUPT;
+                return;
+
+            case L2_STMT_INTERRUPT_CONTINUE: /* the loop has been at the step after its body */
+                irt_p->type = L2_STMT_NO_INTERRUPT;
+                return;
+
+            default:
+                break;
+        }
+    }
+
+    l2_ast_eval_pop_task(machine_p);
+}
+
+/* go on the stmt, the loop stays at the step after its body while the body is running,
+ * the step goes on at once if the value of expr is got without task
+ * */
+void l2_ast_eval_step_stmt(l2_ast_eval_machine *machine_p, l2_ast_eval_task *task_p, l2_stmt_interrupt *irt_p) {
+    l2_ast_node *stmt_p = task_p->node_p, *expr_p, *arg_p;
+    l2_scope *scope_p = task_p->scope_p, *sub_scope_p;
+    l2_procedure procedure;
+
+    switch (stmt_p->type) {
+        case L2_AST_STMT_BLOCK:
+            /* while parse a sub stmts block, a new sub scope should be also created */
+            sub_scope_p = l2_scope_create_common_scope(scope_p, L2_SCOPE_CREATE_SUB_SCOPE);
+            l2_ast_eval_pop_task(machine_p);
+            l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_STMTS, stmt_p, stmt_p->u.block.stmts_p, sub_scope_p, sub_scope_p);
+            break;
+
+        case L2_AST_STMT_PROCEDURE:
+            l2_ast_eval_define_procedure(stmt_p, scope_p, 0);
+            l2_ast_eval_pop_task(machine_p);
+            break;
+
+        case L2_AST_STMT_WHILE:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                if (l2_ast_eval_push_expr(machine_p, stmt_p->u.loop.cond_p, scope_p)) break;
+            }
+
+            if (l2_ast_eval_pop_cond(machine_p, stmt_p)) {
+                task_p->step = 0;
+                sub_scope_p = l2_scope_create_while_scope(scope_p, L2_SCOPE_CREATE_SUB_SCOPE, 0);
+                l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_STMTS, stmt_p, stmt_p->u.loop.body_p, sub_scope_p, sub_scope_p);
+            } else {
+                l2_ast_eval_pop_task(machine_p);
+            }
+            break;
+
+        case L2_AST_STMT_DO_WHILE:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                sub_scope_p = l2_scope_create_do_while_scope(scope_p, L2_SCOPE_CREATE_SUB_SCOPE, 0);
+                l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_STMTS, stmt_p, stmt_p->u.loop.body_p, sub_scope_p, sub_scope_p);
+                break;
+            }
+
+            if (task_p->step == 1) {
+                task_p->step = 2;
+                if (l2_ast_eval_push_expr(machine_p, stmt_p->u.loop.cond_p, scope_p)) break;
+            }
+
+            if (l2_ast_eval_pop_cond(machine_p, stmt_p))
+                task_p->step = 0;
+            else
+                l2_ast_eval_pop_task(machine_p);
+            break;
+
+        case L2_AST_STMT_FOR:
+            /* the variables defined in the first expr are visible in the whole for-loop,
+             * the initialization scope is destroyed along with the task
+             * */
+            switch (task_p->step) {
+                case 0: /* initialization */
+                    task_p->sub_scope_p = l2_scope_create_common_scope(scope_p, L2_SCOPE_CREATE_SUB_SCOPE);
+                    task_p->step = 1;
+                    if (stmt_p->u.for_loop.init_p)
+                        l2_ast_eval_push_stmt(machine_p, stmt_p->u.for_loop.init_p, task_p->sub_scope_p, irt_p);
+                    break;
+
+                case 4: /* the value of step is discarded */
+                    l2_ast_eval_pop_operand(machine_p);
+                    /* fall through */
+
+                case 1: /* condition */
+                    task_p->step = 2;
+                    if (stmt_p->u.for_loop.cond_p && l2_ast_eval_push_expr(machine_p, stmt_p->u.for_loop.cond_p, task_p->sub_scope_p))
+                        break;
+                    /* fall through */
+
+                case 2: /* body, empty condition is true */
+                    if (stmt_p->u.for_loop.cond_p && !l2_ast_eval_pop_cond(machine_p, stmt_p)) {
+                        l2_ast_eval_pop_task(machine_p);
+                        break;
+                    }
+                    task_p->step = 3;
+                    sub_scope_p = l2_scope_create_for_scope(task_p->sub_scope_p, L2_SCOPE_CREATE_SUB_SCOPE, 0);
+                    l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_STMTS, stmt_p, stmt_p->u.for_loop.body_p, sub_scope_p, sub_scope_p);
+                    break;
+
+                default: /* step */
+                    if (stmt_p->u.for_loop.step_p) {
+                        task_p->step = 4;
+                        l2_ast_eval_push_expr(machine_p, stmt_p->u.for_loop.step_p, task_p->sub_scope_p);
+                    } else {
+                        task_p->step = 1;
+                    }
+            }
+            break;
+
+        case L2_AST_STMT_BREAK:
+            irt_p->type = L2_STMT_INTERRUPT_BREAK;
+            irt_p->line_of_irt_stmt = stmt_p->line;
+            irt_p->col_of_irt_stmt = stmt_p->col;
+            break;
+
+        case L2_AST_STMT_CONTINUE:
+            irt_p->type = L2_STMT_INTERRUPT_CONTINUE;
+            irt_p->line_of_irt_stmt = stmt_p->line;
+            irt_p->col_of_irt_stmt = stmt_p->col;
+            break;
+
+        case L2_AST_STMT_RETURN:
+            expr_p = stmt_p->u.stmt_expr.expr_p;
+            irt_p->line_of_irt_stmt = stmt_p->line;
+            irt_p->col_of_irt_stmt = stmt_p->col;
+
+            if (!expr_p) {
+                irt_p->type = L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL; /* has no return value */
+                break;
+            }
+
+            if (expr_p->type != L2_AST_EXPR_CALL) {
+                if (task_p->step == 0) {
+                    task_p->step = 1;
+                    if (l2_ast_eval_push_expr(machine_p, expr_p, scope_p)) break;
+                }
+                irt_p->type = L2_STMT_INTERRUPT_RETURN_WITH_VAL; /* has return value */
+                irt_p->u.ret_expr_info = l2_ast_eval_pop_operand(machine_p);
+                break;
+            }
+
+            /* the real parameters of tail call are evaluated first */
+            switch (task_p->step) {
+                case 0:
+                    task_p->step = 1;
+                    task_p->cursor_p = expr_p->u.call.args_p;
+                    /* fall through */
+
+                case 1:
+                    while (task_p->cursor_p) {
+                        arg_p = task_p->cursor_p;
+                        task_p->cursor_p = arg_p->next_p;
+                        if (l2_ast_eval_push_expr(machine_p, arg_p, scope_p)) return;
+                    }
+
+                    /* the callee is called after current procedure returns if its frame could be reused, otherwise it is called as usual */
+                    procedure = l2_ast_eval_get_procedure(expr_p, scope_p);
+                    if (l2_call_stack_could_reuse_frame(g_parser_p->call_stack_p, scope_p, &procedure,
+                                                        machine_p->operand_stack.stack_p + machine_p->operand_stack.size - expr_p->u.call.args_count,
+                                                        expr_p->u.call.args_count)) {
+                        irt_p->type = L2_STMT_INTERRUPT_TAIL_CALL;
+                        irt_p->u.tail_call.procedure = procedure;
+                        irt_p->u.tail_call.expr_p = expr_p;
+                    } else {
+                        task_p->step = 2;
+                        l2_ast_eval_call(machine_p, expr_p, &procedure, scope_p);
+                    }
+                    break;
+
+                default: /* the value returned by the callee */
+                    irt_p->type = L2_STMT_INTERRUPT_RETURN_WITH_VAL;
+                    irt_p->u.ret_expr_info = l2_ast_eval_pop_operand(machine_p);
+            }
+            break;
+
+        case L2_AST_STMT_IF:
+            /* the branches of if..elif..else are checked one by one */
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                task_p->cursor_p = stmt_p;
+            }
+
+            for (stmt_p = task_p->cursor_p; ; task_p->cursor_p = stmt_p = stmt_p->u.branch.else_p) {
+                if (task_p->step == 1) {
+                    if (!stmt_p || stmt_p->type != L2_AST_STMT_IF) {
+                        l2_ast_eval_pop_task(machine_p);
+                        if (stmt_p) /* else */
+                            l2_ast_eval_push_stmt(machine_p, stmt_p, scope_p, irt_p);
+                        return;
+                    }
+
+                    task_p->step = 2;
+                    if (l2_ast_eval_push_expr(machine_p, stmt_p->u.branch.cond_p, scope_p)) return;
+                }
+
+                if (l2_ast_eval_pop_cond(machine_p, stmt_p)) {
+                    sub_scope_p = l2_scope_create_common_scope(scope_p, L2_SCOPE_CREATE_SUB_SCOPE);
+                    l2_ast_eval_pop_task(machine_p);
+                    l2_ast_eval_push_task(machine_p, L2_AST_EVAL_TASK_STMTS, stmt_p, stmt_p->u.branch.then_p, sub_scope_p, sub_scope_p);
+                    return;
+                }
+                task_p->step = 1;
+            }
+
+        case L2_AST_STMT_VAR:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                task_p->cursor_p = stmt_p->u.var.defs_p;
+            }
+
+            for (; task_p->cursor_p; task_p->cursor_p = task_p->cursor_p->next_p) {
+                if (task_p->step == 1) {
+                    l2_ast_eval_define_var(task_p->cursor_p, scope_p);
+                    if (!task_p->cursor_p->u.var_def.init_p) continue;
+
+                    task_p->step = 2;
+                    if (l2_ast_eval_push_expr(machine_p, task_p->cursor_p->u.var_def.init_p, scope_p)) return;
+                }
+
+                /* with initialization */
+                l2_ast_eval_init_var(task_p->cursor_p, scope_p, l2_ast_eval_pop_operand(machine_p));
+                task_p->step = 1;
+            }
+            l2_ast_eval_pop_task(machine_p);
+            break;
+
+        case L2_AST_STMT_EXPR:
+        case L2_AST_STMT_EVAL:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                if (l2_ast_eval_push_expr(machine_p, stmt_p->u.stmt_expr.expr_p, scope_p)) break;
+            }
+
+            if (stmt_p->type == L2_AST_STMT_EVAL)
+                l2_ast_eval_print(stmt_p, l2_ast_eval_pop_operand(machine_p));
+            else
+                l2_ast_eval_pop_operand(machine_p);
+
+            l2_ast_eval_pop_task(machine_p);
+            break;
+
+        case L2_AST_STMT_EMPTY:
+            /* empty stmt which has only single ; */
+            l2_ast_eval_pop_task(machine_p);
+            break;
+
+        default:
+            l2_internal_error(L2_INTERNAL_ERROR_UNREACHABLE_CODE, "无效的语句节点");
+    }
+}
+
+/* go on the expr which contains calls, the value of it takes the place of the task,
+ * the step goes on at once if the value of sub expr is got without task
+ * */
+void l2_ast_eval_step_expr(l2_ast_eval_machine *machine_p, l2_ast_eval_task *task_p) {
+    l2_ast_node *expr_p = task_p->node_p, *arg_p;
+    l2_scope *scope_p = task_p->scope_p;
+    l2_expr_info expr_info;
+    l2_procedure procedure;
+
+    switch (expr_p->type) {
+        case L2_AST_EXPR_COMMA:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                if (l2_ast_eval_push_expr(machine_p, expr_p->u.binary.left_p, scope_p)) break;
+            }
+            l2_ast_eval_pop_operand(machine_p);
+            l2_ast_eval_pop_task(machine_p);
+            l2_ast_eval_push_expr(machine_p, expr_p->u.binary.right_p, scope_p);
+            break;
+
+        case L2_AST_EXPR_ASSIGN:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                if (l2_ast_eval_push_expr(machine_p, expr_p->u.assign.right_p, scope_p)) break;
+            }
+            l2_ast_eval_pop_task(machine_p);
+            l2_ast_eval_push_operand(machine_p, l2_ast_eval_assign(expr_p, scope_p, l2_ast_eval_pop_operand(machine_p)));
+            break;
+
+        case L2_AST_EXPR_CONDITION:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                if (l2_ast_eval_push_expr(machine_p, expr_p->u.branch.cond_p, scope_p)) break;
+            }
+            l2_ast_eval_pop_task(machine_p);
+            l2_ast_eval_push_expr(machine_p, l2_ast_eval_pop_cond(machine_p, expr_p) ? expr_p->u.branch.then_p : expr_p->u.branch.else_p, scope_p);
+            break;
+
+        case L2_AST_EXPR_BINARY:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                if (l2_ast_eval_push_expr(machine_p, expr_p->u.binary.left_p, scope_p)) break;
+            }
+
+            if (task_p->step == 1) {
+                /* the left value is the result if it is short-circuited */
+                if (l2_ast_eval_short_circuit(expr_p, machine_p->operand_stack.stack_p[machine_p->operand_stack.size - 1])) {
+                    l2_ast_eval_pop_task(machine_p);
+                    break;
+                }
+                task_p->step = 2;
+                if (l2_ast_eval_push_expr(machine_p, expr_p->u.binary.right_p, scope_p)) break;
+            }
+
+            expr_info = l2_ast_eval_pop_operand(machine_p);
+            l2_ast_eval_pop_task(machine_p);
+            l2_ast_eval_push_operand(machine_p, l2_ast_eval_dualistic(expr_p, l2_ast_eval_pop_operand(machine_p), expr_info));
+            break;
+
+        case L2_AST_EXPR_UNARY:
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                if (l2_ast_eval_push_expr(machine_p, expr_p->u.unary.operand_p, scope_p)) break;
+            }
+            l2_ast_eval_pop_task(machine_p);
+            l2_ast_eval_push_operand(machine_p, l2_ast_eval_unitary(expr_p, l2_ast_eval_pop_operand(machine_p)));
+            break;
+
+        case L2_AST_EXPR_CALL:
+            /* the real parameters are evaluated in the scope of caller one by one */
+            if (task_p->step == 0) {
+                task_p->step = 1;
+                task_p->cursor_p = expr_p->u.call.args_p;
+            }
+
+            while (task_p->cursor_p) {
+                arg_p = task_p->cursor_p;
+                task_p->cursor_p = arg_p->next_p;
+                if (l2_ast_eval_push_expr(machine_p, arg_p, scope_p)) return;
+            }
+
+            procedure = l2_ast_eval_get_procedure(expr_p, scope_p);
+            l2_ast_eval_pop_task(machine_p);
+            l2_ast_eval_call(machine_p, expr_p, &procedure, scope_p);
+            break;
+
+        default: /* the exprs without calls are evaluated by recursion */
+            l2_internal_error(L2_INTERNAL_ERROR_UNREACHABLE_CODE, "无效的表达式节点");
+    }
+}
+
+/* run the stmts on the task stack, the calls are performed with the frames on call stack instead of host recursion */
+l2_stmt_interrupt l2_ast_eval_run(l2_ast_node *stmts_p, l2_scope *scope_p) {
+    l2_stmt_interrupt irt = { .type = L2_STMT_NO_INTERRUPT };
+    l2_ast_eval_machine machine;
+    l2_ast_eval_task *task_p;
+    l2_ast_node *stmt_p;
+
+    l2_ast_eval_task_stack_create(&machine.task_stack);
+    l2_expr_info_stack_create(&machine.operand_stack);
+    l2_ast_eval_push_task(&machine, L2_AST_EVAL_TASK_STMTS, L2_NULL_PTR, stmts_p, scope_p, L2_NULL_PTR);
+
+    while (machine.task_stack.size > 0) {
+        if (irt.type != L2_STMT_NO_INTERRUPT) {
+            l2_ast_eval_unwind(&machine, &irt);
+            continue;
+        }
+
+        /* the task may be moved by the pushes, so it is not used after them */
+        task_p = l2_ast_eval_task_stack_back(&machine.task_stack);
+
+        switch (task_p->type) {
+            case L2_AST_EVAL_TASK_STMTS:
+                if (!task_p->cursor_p) {
+                    l2_ast_eval_pop_task(&machine);
+                    break;
+                }
+                stmt_p = task_p->cursor_p;
+                task_p->cursor_p = stmt_p->next_p;
+                l2_ast_eval_push_stmt(&machine, stmt_p, task_p->scope_p, &irt);
+                break;
+
+            case L2_AST_EVAL_TASK_STMT:
+                l2_ast_eval_step_stmt(&machine, task_p, &irt);
+                break;
+
+            case L2_AST_EVAL_TASK_EXPR:
+                l2_ast_eval_step_expr(&machine, task_p);
+                break;
+
+            case L2_AST_EVAL_TASK_BODY:
+                if (task_p->step == 0) {
+                    task_p->step = 1;
+                    l2_ast_eval_push_task(&machine, L2_AST_EVAL_TASK_STMTS, task_p->node_p, task_p->node_p->u.procedure.body_p,
+                                          task_p->scope_p, L2_NULL_PTR);
+                } else {
+                    l2_ast_eval_return(&machine, task_p, &irt); /* no return stmt */
+                }
+                break;
+        }
+    }
+
+    l2_ast_eval_task_stack_destroy(&machine.task_stack);
+    l2_expr_info_stack_destroy(&machine.operand_stack);
+    return irt;
+}
+
+void l2_ast_eval_program() {
+    l2_ast_node *stmt_p;
+    l2_ast_mark mark;
+
+    if (_is_stream) {
+        /* each stmt is executed as soon as it has been parsed, and its nodes are released after that */
+        mark = l2_ast_get_mark();
+        while ((stmt_p = l2_ast_parse_stmt())) {
+            l2_ast_resolve_program(stmt_p);
+            l2_ast_eval_run(stmt_p, g_parser_p->global_scope_p);
+            l2_ast_release_since(&mark);
+            _stream_release
+            _repl /* prompt */
+        }
+
+        _if_type (L2_TOKEN_TERMINATOR)
+        {
+            /* reach the end of input */
+        } _throw_unexpected_token
+
+    } else {
+        /* parse the whole source once, then execute the tree */
+        stmt_p = l2_ast_parse_program();
+        l2_ast_resolve_program(stmt_p);
+        l2_ast_eval_run(stmt_p, g_parser_p->global_scope_p);
+    }
+}
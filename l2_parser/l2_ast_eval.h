@@ -0,0 +1,54 @@
+#ifndef _L2_AST_EVAL_H_
+#define _L2_AST_EVAL_H_
+
+#include "../l2_tpl/l2_stack.h"
+#include "l2_ast.h"
+#include "l2_parse.h"
+#include "l2_eval.h"
+#include "l2_scope.h"
+
+typedef enum _l2_ast_eval_task_type {
+    L2_AST_EVAL_TASK_STMTS, /* run the stmts from cursor one by one */
+    L2_AST_EVAL_TASK_STMT, /* run the stmt step by step */
+    L2_AST_EVAL_TASK_EXPR, /* evaluate the expr which contains calls, its value is pushed onto operand stack */
+    L2_AST_EVAL_TASK_BODY /* run the body of procedure called, with the frame on call stack */
+}l2_ast_eval_task_type;
+
+/* the node in evaluation, it is resumed at the step after its sub nodes are done */
+typedef struct _l2_ast_eval_task {
+    l2_ast_eval_task_type type;
+    int step;
+    l2_ast_node *node_p;
+    l2_ast_node *cursor_p; /* the next stmt, variable definition, argument or branch */
+    l2_scope *scope_p; /* the scope where the node is evaluated */
+    l2_scope *sub_scope_p; /* the scope created for the node, escaped when the task is popped */
+}l2_ast_eval_task;
+
+L2_STACK_DEFINE(l2_ast_eval_task)
+
+/* the stmts and the exprs which contain calls are evaluated by tasks, so the depth of calls is not limited by host stack */
+typedef struct _l2_ast_eval_machine {
+    l2_ast_eval_task_stack task_stack;
+    l2_expr_info_stack operand_stack;
+}l2_ast_eval_machine;
+
+void l2_ast_eval_program();
+l2_stmt_interrupt l2_ast_eval_run(l2_ast_node *stmts_p, l2_scope *scope_p);
+
+l2_expr_info l2_ast_eval_expr(l2_ast_node *expr_p, l2_scope *scope_p);
+
+/* the operations shared with vm */
+l2_expr_info l2_ast_eval_assign(l2_ast_node *expr_p, l2_scope *scope_p, l2_expr_info right_expr_info);
+boolean l2_ast_eval_short_circuit(l2_ast_node *expr_p, l2_expr_info left_expr_info);
+l2_expr_info l2_ast_eval_dualistic(l2_ast_node *expr_p, l2_expr_info left_expr_info, l2_expr_info right_expr_info);
+l2_expr_info l2_ast_eval_unitary(l2_ast_node *expr_p, l2_expr_info right_expr_info);
+l2_expr_info l2_ast_eval_identifier(l2_ast_node *expr_p, l2_scope *scope_p);
+l2_procedure l2_ast_eval_get_procedure(l2_ast_node *expr_p, l2_scope *scope_p);
+void l2_ast_eval_bind_param(l2_ast_node *param_p, l2_scope *procedure_scope_p, l2_expr_info arg_expr_info, int err_line, int err_col);
+l2_scope *l2_ast_eval_bind_params(l2_ast_node *expr_p, l2_procedure *procedure_p, l2_expr_info *args_p);
+void l2_ast_eval_define_procedure(l2_ast_node *stmt_p, l2_scope *scope_p, int entry_pos);
+void l2_ast_eval_define_var(l2_ast_node *def_p, l2_scope *scope_p);
+void l2_ast_eval_init_var(l2_ast_node *def_p, l2_scope *scope_p, l2_expr_info expr_info);
+void l2_ast_eval_print(l2_ast_node *stmt_p, l2_expr_info expr_info);
+
+#endif
@@ -0,0 +1,298 @@
+#include "l2_ast_resolve.h"
+#include "l2_parse.h"
+#include "../l2_drv/l2_error.h"
+
+#define L2_AST_RESOLVE_NO_NAME (-1)
+#define L2_AST_RESOLVE_INIT_BUCKETS_COUNT 8
+
+extern l2_parser *g_parser_p;
+
+void l2_ast_resolve_stmts(l2_ast_node *stmts_p, l2_ast_resolve_scope *scope_p);
+boolean l2_ast_resolve_expr(l2_ast_node *expr_p, l2_ast_resolve_scope *scope_p);
+
+void l2_ast_resolve_scope_enter(l2_ast_resolve_scope *scope_p, l2_ast_resolve_scope *upper_scope_p, boolean is_procedure_scope) {
+    scope_p->upper_p = upper_scope_p;
+    scope_p->is_procedure_scope = is_procedure_scope;
+    scope_p->slots_count = 0;
+    scope_p->buckets_p = L2_NULL_PTR; /* the buckets would be allocated when the first name is declared */
+    scope_p->buckets_count = 0;
+    l2_ast_resolve_name_vector_create(&scope_p->name_vec);
+}
+
+void l2_ast_resolve_scope_leave(l2_ast_resolve_scope *scope_p) {
+    if (scope_p->buckets_p) l2_storage_mem_delete(g_parser_p->storage_p, scope_p->buckets_p);
+    l2_ast_resolve_name_vector_destroy(&scope_p->name_vec);
+}
+
+void l2_ast_resolve_scope_destroy(l2_ast_resolve_scope *scope_p) {
+    l2_ast_resolve_scope_leave(scope_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, scope_p);
+}
+
+void l2_ast_resolve_link_bucket(l2_ast_resolve_scope *scope_p, int index) {
+    l2_ast_resolve_name *names_p = scope_p->name_vec.vector_p;
+    unsigned int mask = scope_p->buckets_count - 1, i;
+
+    for (i = l2_intern_atom(names_p[index].id) & mask; scope_p->buckets_p[i] != L2_AST_RESOLVE_NO_NAME; i = (i + 1) & mask);
+    scope_p->buckets_p[i] = index;
+}
+
+void l2_ast_resolve_rehash(l2_ast_resolve_scope *scope_p, int buckets_count) {
+    int i;
+
+    if (scope_p->buckets_p) l2_storage_mem_delete(g_parser_p->storage_p, scope_p->buckets_p);
+    scope_p->buckets_p = l2_storage_mem_new(g_parser_p->storage_p, buckets_count * sizeof(int));
+    scope_p->buckets_count = buckets_count;
+
+    for (i = 0; i < buckets_count; i++) scope_p->buckets_p[i] = L2_AST_RESOLVE_NO_NAME;
+    for (i = 0; i < (int)scope_p->name_vec.size; i++) l2_ast_resolve_link_bucket(scope_p, i);
+}
+
+l2_ast_resolve_name *l2_ast_resolve_find_name(l2_ast_resolve_scope *scope_p, char *id) {
+    l2_ast_resolve_name *names_p = scope_p->name_vec.vector_p;
+    unsigned int mask, i;
+
+    if (!scope_p->buckets_p) return L2_NULL_PTR;
+
+    mask = scope_p->buckets_count - 1;
+    for (i = l2_intern_atom(id) & mask; scope_p->buckets_p[i] != L2_AST_RESOLVE_NO_NAME; i = (i + 1) & mask) {
+        if (names_p[scope_p->buckets_p[i]].id == id) return &names_p[scope_p->buckets_p[i]]; /* the ids are interned */
+    }
+    return L2_NULL_PTR;
+}
+
+void l2_ast_resolve_declare_name(l2_ast_resolve_scope *scope_p, char *id) {
+    l2_ast_resolve_name name;
+
+    if (l2_ast_resolve_find_name(scope_p, id)) return;
+
+    name.id = id;
+    name.slot = L2_AST_RESOLVE_NOT_DEFINED;
+    l2_ast_resolve_name_vector_append(&scope_p->name_vec, name);
+
+    if ((int)scope_p->name_vec.size * 2 > scope_p->buckets_count)
+        l2_ast_resolve_rehash(scope_p, scope_p->buckets_count ? scope_p->buckets_count * 2 : L2_AST_RESOLVE_INIT_BUCKETS_COUNT);
+    else
+        l2_ast_resolve_link_bucket(scope_p, scope_p->name_vec.size - 1);
+}
+
+/* declare all of the names which would be defined by stmts in the scope, before any of them is resolved,
+ * so that the procedure could know whether an outer name may be shadowed before it is called
+ * */
+void l2_ast_resolve_declare_stmts(l2_ast_node *stmts_p, l2_ast_resolve_scope *scope_p) {
+    l2_ast_node *def_p;
+
+    for (; stmts_p; stmts_p = stmts_p->next_p) {
+        switch (stmts_p->type) {
+            case L2_AST_STMT_VAR:
+                for (def_p = stmts_p->u.var.defs_p; def_p; def_p = def_p->next_p)
+                    l2_ast_resolve_declare_name(scope_p, def_p->u.var_def.id);
+                break;
+
+            case L2_AST_STMT_PROCEDURE:
+                l2_ast_resolve_declare_name(scope_p, stmts_p->u.procedure.id);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+/* the symbols are stored into the slots of scope in order of definition at run time,
+ * returns the slot of the definition, or L2_AST_SLOT_REDEFINED if the name has been defined before
+ * */
+int l2_ast_resolve_define_name(l2_ast_resolve_scope *scope_p, char *id) {
+    l2_ast_resolve_name *name_p;
+
+    l2_ast_resolve_declare_name(scope_p, id);
+    name_p = l2_ast_resolve_find_name(scope_p, id);
+
+    if (name_p->slot != L2_AST_RESOLVE_NOT_DEFINED) return L2_AST_SLOT_REDEFINED;
+
+    name_p->slot = scope_p->slots_count++;
+    return name_p->slot;
+}
+
+/* bind the identifier to the nearest definition which has been reached,
+ * if the identifier refers to a name outside the procedure, which could be defined or shadowed after the definition of procedure,
+ * it should be looked up by name at run time
+ * */
+l2_ast_addr l2_ast_resolve_ref(l2_ast_resolve_scope *scope_p, char *id) {
+    l2_ast_addr addr;
+    l2_ast_resolve_name *name_p;
+    boolean out_of_procedure = L2_FALSE;
+
+    for (addr.hops = 0; scope_p; scope_p = scope_p->upper_p, addr.hops++) {
+        name_p = l2_ast_resolve_find_name(scope_p, id);
+
+        if (name_p) {
+            if (name_p->slot != L2_AST_RESOLVE_NOT_DEFINED) {
+                addr.slot = name_p->slot;
+                return addr;
+            }
+
+            if (out_of_procedure) break;
+        }
+
+        if (scope_p->is_procedure_scope) out_of_procedure = L2_TRUE;
+    }
+
+    addr.hops = L2_AST_ADDR_UNRESOLVED;
+    addr.slot = 0;
+    return addr;
+}
+
+/* resolve the stmts which are run in a new sub scope */
+void l2_ast_resolve_sub_scope_stmts(l2_ast_node *stmts_p, l2_ast_resolve_scope *scope_p) {
+    l2_ast_resolve_scope sub_scope;
+
+    l2_ast_resolve_scope_enter(&sub_scope, scope_p, L2_FALSE);
+    l2_ast_resolve_declare_stmts(stmts_p, &sub_scope);
+    l2_ast_resolve_stmts(stmts_p, &sub_scope);
+    l2_ast_resolve_scope_leave(&sub_scope);
+}
+
+void l2_ast_resolve_stmt(l2_ast_node *stmt_p, l2_ast_resolve_scope *scope_p) {
+    l2_ast_resolve_scope sub_scope, for_scope;
+    l2_ast_node *def_p;
+
+    switch (stmt_p->type) {
+        case L2_AST_STMT_BLOCK:
+            l2_ast_resolve_sub_scope_stmts(stmt_p->u.block.stmts_p, scope_p);
+            break;
+
+        case L2_AST_STMT_PROCEDURE:
+            /* the procedure is defined before its body could be run, so it could call itself */
+            stmt_p->u.procedure.slot = l2_ast_resolve_define_name(scope_p, stmt_p->u.procedure.id);
+
+            /* the formal parameters take the first slots of procedure scope */
+            l2_ast_resolve_scope_enter(&sub_scope, scope_p, L2_TRUE);
+            for (def_p = stmt_p->u.procedure.params_p; def_p; def_p = def_p->next_p)
+                def_p->u.var_def.slot = l2_ast_resolve_define_name(&sub_scope, def_p->u.var_def.id);
+
+            l2_ast_resolve_declare_stmts(stmt_p->u.procedure.body_p, &sub_scope);
+            l2_ast_resolve_stmts(stmt_p->u.procedure.body_p, &sub_scope);
+            l2_ast_resolve_scope_leave(&sub_scope);
+            break;
+
+        case L2_AST_STMT_WHILE:
+        case L2_AST_STMT_DO_WHILE:
+            l2_ast_resolve_expr(stmt_p->u.loop.cond_p, scope_p);
+            l2_ast_resolve_sub_scope_stmts(stmt_p->u.loop.body_p, scope_p);
+            break;
+
+        case L2_AST_STMT_FOR:
+            /* the variables defined in the first expr are visible in the whole for-loop */
+            l2_ast_resolve_scope_enter(&for_scope, scope_p, L2_FALSE);
+
+            if (stmt_p->u.for_loop.init_p) {
+                l2_ast_resolve_declare_stmts(stmt_p->u.for_loop.init_p, &for_scope);
+                l2_ast_resolve_stmt(stmt_p->u.for_loop.init_p, &for_scope);
+            }
+            if (stmt_p->u.for_loop.cond_p)
+                l2_ast_resolve_expr(stmt_p->u.for_loop.cond_p, &for_scope);
+            if (stmt_p->u.for_loop.step_p)
+                l2_ast_resolve_expr(stmt_p->u.for_loop.step_p, &for_scope);
+
+            l2_ast_resolve_sub_scope_stmts(stmt_p->u.for_loop.body_p, &for_scope);
+            l2_ast_resolve_scope_leave(&for_scope);
+            break;
+
+        case L2_AST_STMT_IF:
+            /* the branches of if..elif..else */
+            while (stmt_p && stmt_p->type == L2_AST_STMT_IF) {
+                l2_ast_resolve_expr(stmt_p->u.branch.cond_p, scope_p);
+                l2_ast_resolve_sub_scope_stmts(stmt_p->u.branch.then_p, scope_p);
+                stmt_p = stmt_p->u.branch.else_p;
+            }
+
+            if (stmt_p) /* else */
+                l2_ast_resolve_stmt(stmt_p, scope_p);
+            break;
+
+        case L2_AST_STMT_VAR:
+            /* the variable is defined before its initialization expr is evaluated */
+            for (def_p = stmt_p->u.var.defs_p; def_p; def_p = def_p->next_p) {
+                def_p->u.var_def.slot = l2_ast_resolve_define_name(scope_p, def_p->u.var_def.id);
+
+                if (def_p->u.var_def.init_p)
+                    l2_ast_resolve_expr(def_p->u.var_def.init_p, scope_p);
+            }
+            break;
+
+        case L2_AST_STMT_RETURN:
+        case L2_AST_STMT_EXPR:
+        case L2_AST_STMT_EVAL:
+            if (stmt_p->u.stmt_expr.expr_p)
+                l2_ast_resolve_expr(stmt_p->u.stmt_expr.expr_p, scope_p);
+            break;
+
+        default: /* break, continue and empty stmt */
+            break;
+    }
+}
+
+void l2_ast_resolve_stmts(l2_ast_node *stmts_p, l2_ast_resolve_scope *scope_p) {
+    for (; stmts_p; stmts_p = stmts_p->next_p)
+        l2_ast_resolve_stmt(stmts_p, scope_p);
+}
+
+/* resolve the identifiers in expr, returns true if it contains calls */
+boolean l2_ast_resolve_expr(l2_ast_node *expr_p, l2_ast_resolve_scope *scope_p) {
+    l2_ast_node *arg_p;
+    boolean has_call = L2_FALSE;
+
+    switch (expr_p->type) {
+        case L2_AST_EXPR_COMMA:
+        case L2_AST_EXPR_BINARY:
+            has_call = l2_ast_resolve_expr(expr_p->u.binary.left_p, scope_p);
+            has_call |= l2_ast_resolve_expr(expr_p->u.binary.right_p, scope_p);
+            break;
+
+        case L2_AST_EXPR_ASSIGN:
+            expr_p->u.assign.addr = l2_ast_resolve_ref(scope_p, expr_p->u.assign.id);
+            has_call = l2_ast_resolve_expr(expr_p->u.assign.right_p, scope_p);
+            break;
+
+        case L2_AST_EXPR_CONDITION:
+            has_call = l2_ast_resolve_expr(expr_p->u.branch.cond_p, scope_p);
+            has_call |= l2_ast_resolve_expr(expr_p->u.branch.then_p, scope_p);
+            has_call |= l2_ast_resolve_expr(expr_p->u.branch.else_p, scope_p);
+            break;
+
+        case L2_AST_EXPR_UNARY:
+            has_call = l2_ast_resolve_expr(expr_p->u.unary.operand_p, scope_p);
+            break;
+
+        case L2_AST_EXPR_IDENTIFIER:
+            expr_p->u.ref.addr = l2_ast_resolve_ref(scope_p, expr_p->u.ref.id);
+            break;
+
+        case L2_AST_EXPR_CALL:
+            expr_p->u.call.addr = l2_ast_resolve_ref(scope_p, expr_p->u.call.id);
+            for (arg_p = expr_p->u.call.args_p; arg_p; arg_p = arg_p->next_p)
+                l2_ast_resolve_expr(arg_p, scope_p);
+            has_call = L2_TRUE;
+            break;
+
+        default: /* literals */
+            break;
+    }
+
+    expr_p->has_call = has_call;
+    return has_call;
+}
+
+/* resolve the stmts of global scope, the global names are kept for the following stmts of repl */
+void l2_ast_resolve_program(l2_ast_node *stmts_p) {
+    l2_ast *ast_p = g_parser_p->ast_p;
+
+    if (!ast_p->global_scope_p) {
+        ast_p->global_scope_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_ast_resolve_scope));
+        l2_ast_resolve_scope_enter(ast_p->global_scope_p, L2_NULL_PTR, L2_FALSE);
+    }
+
+    l2_ast_resolve_declare_stmts(stmts_p, ast_p->global_scope_p);
+    l2_ast_resolve_stmts(stmts_p, ast_p->global_scope_p);
+}
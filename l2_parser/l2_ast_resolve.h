@@ -0,0 +1,29 @@
+#ifndef _L2_AST_RESOLVE_H_
+#define _L2_AST_RESOLVE_H_
+
+#include "../l2_tpl/l2_vector.h"
+#include "l2_ast.h"
+
+#define L2_AST_RESOLVE_NOT_DEFINED (-1) /* the name is declared in scope, but its definition is not reached yet */
+
+typedef struct _l2_ast_resolve_name {
+    char *id;
+    int slot;
+}l2_ast_resolve_name;
+
+L2_VECTOR_DEFINE(l2_ast_resolve_name)
+
+typedef struct _l2_ast_resolve_scope {
+    struct _l2_ast_resolve_scope *upper_p;
+    boolean is_procedure_scope;
+    l2_ast_resolve_name_vector name_vec; /* all of the names declared in this scope */
+    int *buckets_p; /* the indexes of names in name_vec, probed by atom of name */
+    int buckets_count; /* power of 2, the buckets are at most half full */
+    int slots_count;
+}l2_ast_resolve_scope;
+
+void l2_ast_resolve_scope_destroy(l2_ast_resolve_scope *scope_p);
+
+void l2_ast_resolve_program(l2_ast_node *stmts_p);
+
+#endif
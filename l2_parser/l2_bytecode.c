@@ -0,0 +1,384 @@
+#include "l2_bytecode.h"
+#include "l2_parse.h"
+#include "../l2_drv/l2_error.h"
+
+extern l2_parser *g_parser_p;
+
+void l2_bytecode_compile_stmt(l2_bytecode *bytecode_p, l2_ast_node *stmt_p);
+void l2_bytecode_compile_expr(l2_bytecode *bytecode_p, l2_ast_node *expr_p);
+
+l2_bytecode *l2_bytecode_create() {
+    l2_bytecode *bytecode_p;
+    bytecode_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_bytecode));
+    l2_bytecode_inst_vector_create(&bytecode_p->inst_vec);
+    bytecode_p->loop_p = L2_NULL_PTR;
+    bytecode_p->scope_depth = 0;
+    return bytecode_p;
+}
+
+void l2_bytecode_destroy(l2_bytecode *bytecode_p) {
+    l2_bytecode_inst_vector_destroy(&bytecode_p->inst_vec);
+    l2_storage_mem_delete(g_parser_p->storage_p, bytecode_p);
+}
+
+/* the position of next instruction */
+int l2_bytecode_pos(l2_bytecode *bytecode_p) {
+    return bytecode_p->inst_vec.size;
+}
+
+/* append an instruction, returns the position of it */
+int l2_bytecode_emit(l2_bytecode *bytecode_p, l2_bytecode_opcode opcode, int arg, l2_ast_node *node_p) {
+    l2_bytecode_inst inst;
+    inst.opcode = opcode;
+    inst.arg = arg;
+    inst.u.node_p = node_p;
+    l2_bytecode_inst_vector_append(&bytecode_p->inst_vec, inst);
+    return bytecode_p->inst_vec.size - 1;
+}
+
+l2_bytecode_inst *l2_bytecode_at(l2_bytecode *bytecode_p, int pos) {
+    return l2_bytecode_inst_vector_at(&bytecode_p->inst_vec, pos);
+}
+
+/* the jumps which wait to be patched are chained by their args, fill the target position into all of them */
+void l2_bytecode_patch_chain(l2_bytecode *bytecode_p, int chain, int target_pos) {
+    l2_bytecode_inst *inst_p;
+
+    while (chain != L2_BYTECODE_NO_POS) {
+        inst_p = l2_bytecode_at(bytecode_p, chain);
+        chain = inst_p->arg;
+        inst_p->arg = target_pos;
+    }
+}
+
+/* escape from the scopes between current position and the loop body, then jump out of the body */
+int l2_bytecode_emit_loop_jump(l2_bytecode *bytecode_p, int chain) {
+    int i;
+
+    for (i = bytecode_p->scope_depth; i >= bytecode_p->loop_p->scope_depth; i--)
+        l2_bytecode_emit(bytecode_p, L2_BYTECODE_LEAVE_SCOPE, 0, L2_NULL_PTR);
+
+    return l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP, chain, L2_NULL_PTR);
+}
+
+void l2_bytecode_compile_stmts(l2_bytecode *bytecode_p, l2_ast_node *stmts_p) {
+    for (; stmts_p; stmts_p = stmts_p->next_p)
+        l2_bytecode_compile_stmt(bytecode_p, stmts_p);
+}
+
+/* while run a sub stmts block, a new sub scope should be also created */
+void l2_bytecode_compile_scope_stmts(l2_bytecode *bytecode_p, l2_ast_node *stmts_p, l2_scope_type scope_type) {
+    l2_bytecode_emit(bytecode_p, L2_BYTECODE_ENTER_SCOPE, scope_type, L2_NULL_PTR);
+    bytecode_p->scope_depth += 1;
+    l2_bytecode_compile_stmts(bytecode_p, stmts_p);
+    bytecode_p->scope_depth -= 1;
+    l2_bytecode_emit(bytecode_p, L2_BYTECODE_LEAVE_SCOPE, 0, L2_NULL_PTR);
+}
+
+/* the loop body runs in a new sub scope each time, the break and continue inside it are recorded into loop */
+void l2_bytecode_compile_loop_body(l2_bytecode *bytecode_p, l2_ast_node *body_p, l2_scope_type scope_type, l2_bytecode_loop *loop_p) {
+    loop_p->upper_p = bytecode_p->loop_p;
+    loop_p->scope_depth = bytecode_p->scope_depth + 1;
+    loop_p->break_chain = L2_BYTECODE_NO_POS;
+    loop_p->continue_chain = L2_BYTECODE_NO_POS;
+
+    bytecode_p->loop_p = loop_p;
+    l2_bytecode_compile_scope_stmts(bytecode_p, body_p, scope_type);
+    bytecode_p->loop_p = loop_p->upper_p;
+}
+
+/* the condition of loop and branch must be a bool value, err_node_p is reported if it is not */
+int l2_bytecode_compile_cond(l2_bytecode *bytecode_p, l2_ast_node *cond_p, l2_ast_node *err_node_p) {
+    l2_bytecode_compile_expr(bytecode_p, cond_p);
+    return l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP_IF_FALSE, L2_BYTECODE_NO_POS, err_node_p);
+}
+
+/* the real parameters are evaluated in the scope of caller, and pushed in order */
+void l2_bytecode_compile_args(l2_bytecode *bytecode_p, l2_ast_node *call_p) {
+    l2_ast_node *arg_p;
+
+    for (arg_p = call_p->u.call.args_p; arg_p; arg_p = arg_p->next_p)
+        l2_bytecode_compile_expr(bytecode_p, arg_p);
+}
+
+/* the opcode performing the dualistic operator, which is inline for integer operands */
+l2_bytecode_opcode l2_bytecode_dualistic_opcode(l2_token_type opr) {
+    switch (opr) {
+        case L2_TOKEN_PLUS: return L2_BYTECODE_ADD;
+        case L2_TOKEN_SUB: return L2_BYTECODE_SUB;
+        case L2_TOKEN_MUL: return L2_BYTECODE_MUL;
+        case L2_TOKEN_DIV: return L2_BYTECODE_DIV;
+        case L2_TOKEN_MOD: return L2_BYTECODE_MOD;
+        case L2_TOKEN_BIT_AND: return L2_BYTECODE_BIT_AND;
+        case L2_TOKEN_BIT_XOR: return L2_BYTECODE_BIT_XOR;
+        case L2_TOKEN_BIT_OR: return L2_BYTECODE_BIT_OR;
+        case L2_TOKEN_LSHIFT: return L2_BYTECODE_LSHIFT;
+        case L2_TOKEN_RSHIFT: return L2_BYTECODE_RSHIFT;
+        case L2_TOKEN_EQUAL: return L2_BYTECODE_EQUAL;
+        case L2_TOKEN_NOT_EQUAL: return L2_BYTECODE_NOT_EQUAL;
+        case L2_TOKEN_GREAT_THAN: return L2_BYTECODE_GREAT_THAN;
+        case L2_TOKEN_GREAT_EQUAL_THAN: return L2_BYTECODE_GREAT_EQUAL_THAN;
+        case L2_TOKEN_LESS_THAN: return L2_BYTECODE_LESS_THAN;
+        case L2_TOKEN_LESS_EQUAL_THAN: return L2_BYTECODE_LESS_EQUAL_THAN;
+        default: return L2_BYTECODE_DUALISTIC;
+    }
+}
+
+/* the identifier resolved is addressed directly, the others are looked up by name */
+void l2_bytecode_emit_addr(l2_bytecode *bytecode_p, l2_bytecode_opcode opcode, l2_bytecode_opcode addr_opcode, l2_ast_addr addr, l2_ast_node *expr_p) {
+    if (addr.hops == L2_AST_ADDR_UNRESOLVED) {
+        l2_bytecode_emit(bytecode_p, opcode, 0, expr_p);
+        return;
+    }
+
+    l2_bytecode_emit(bytecode_p, addr_opcode, 0, expr_p);
+    l2_bytecode_at(bytecode_p, l2_bytecode_pos(bytecode_p) - 1)->addr = addr;
+}
+
+void l2_bytecode_compile_expr(l2_bytecode *bytecode_p, l2_ast_node *expr_p) {
+    int else_pos, end_pos;
+
+    switch (expr_p->type) {
+        case L2_AST_EXPR_COMMA:
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.binary.left_p);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_POP, 0, L2_NULL_PTR);
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.binary.right_p);
+            break;
+
+        case L2_AST_EXPR_ASSIGN:
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.assign.right_p);
+            if (expr_p->u.assign.opr == L2_TOKEN_ASSIGN)
+                l2_bytecode_emit_addr(bytecode_p, L2_BYTECODE_ASSIGN, L2_BYTECODE_STORE_ADDR, expr_p->u.assign.addr, expr_p);
+            else
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_ASSIGN, 0, expr_p);
+            break;
+
+        case L2_AST_EXPR_CONDITION:
+            else_pos = l2_bytecode_compile_cond(bytecode_p, expr_p->u.branch.cond_p, expr_p);
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.branch.then_p);
+            end_pos = l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP, L2_BYTECODE_NO_POS, L2_NULL_PTR);
+            l2_bytecode_patch_chain(bytecode_p, else_pos, l2_bytecode_pos(bytecode_p));
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.branch.else_p);
+            l2_bytecode_patch_chain(bytecode_p, end_pos, l2_bytecode_pos(bytecode_p));
+            break;
+
+        case L2_AST_EXPR_BINARY:
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.binary.left_p);
+
+            if (expr_p->u.binary.opr == L2_TOKEN_LOGIC_OR || expr_p->u.binary.opr == L2_TOKEN_LOGIC_AND) {
+                /* the left value is the result if the right side is skipped */
+                end_pos = l2_bytecode_emit(bytecode_p, L2_BYTECODE_SHORT_CIRCUIT, L2_BYTECODE_NO_POS, expr_p);
+                l2_bytecode_compile_expr(bytecode_p, expr_p->u.binary.right_p);
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_DUALISTIC, 0, expr_p);
+                l2_bytecode_patch_chain(bytecode_p, end_pos, l2_bytecode_pos(bytecode_p));
+                break;
+            }
+
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.binary.right_p);
+            l2_bytecode_emit(bytecode_p, l2_bytecode_dualistic_opcode(expr_p->u.binary.opr), 0, expr_p);
+            break;
+
+        case L2_AST_EXPR_UNARY:
+            l2_bytecode_compile_expr(bytecode_p, expr_p->u.unary.operand_p);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_UNITARY, 0, expr_p);
+            break;
+
+        case L2_AST_EXPR_IDENTIFIER:
+            l2_bytecode_emit_addr(bytecode_p, L2_BYTECODE_LOAD, L2_BYTECODE_LOAD_ADDR, expr_p->u.ref.addr, expr_p);
+            break;
+
+        case L2_AST_EXPR_CALL:
+            l2_bytecode_compile_args(bytecode_p, expr_p);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_CALL, expr_p->u.call.args_count, expr_p);
+            break;
+
+        case L2_AST_EXPR_INTEGER:
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_PUSH_INTEGER, 0, L2_NULL_PTR);
+            l2_bytecode_at(bytecode_p, l2_bytecode_pos(bytecode_p) - 1)->u.integer = expr_p->u.integer;
+            break;
+
+        case L2_AST_EXPR_REAL:
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_PUSH_REAL, 0, L2_NULL_PTR);
+            l2_bytecode_at(bytecode_p, l2_bytecode_pos(bytecode_p) - 1)->u.real = expr_p->u.real;
+            break;
+
+        case L2_AST_EXPR_BOOL:
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_PUSH_BOOL, 0, L2_NULL_PTR);
+            l2_bytecode_at(bytecode_p, l2_bytecode_pos(bytecode_p) - 1)->u.bool = expr_p->u.bool;
+            break;
+
+        default:
+            l2_internal_error(L2_INTERNAL_ERROR_UNREACHABLE_CODE, "无效的表达式节点");
+    }
+}
+
+void l2_bytecode_compile_stmt(l2_bytecode *bytecode_p, l2_ast_node *stmt_p) {
+    l2_bytecode_loop loop, *upper_loop_p;
+    l2_ast_node *def_p;
+    int cond_pos, next_pos, end_chain, upper_scope_depth;
+
+    switch (stmt_p->type) {
+        case L2_AST_STMT_BLOCK:
+            l2_bytecode_compile_scope_stmts(bytecode_p, stmt_p->u.block.stmts_p, L2_SCOPE_TYPE_COMMON);
+            break;
+
+        case L2_AST_STMT_PROCEDURE:
+            /* the procedure body follows the jump which skips it, and ends with an implicit return */
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_DEFINE_PROCEDURE, l2_bytecode_pos(bytecode_p) + 2, stmt_p);
+            end_chain = l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP, L2_BYTECODE_NO_POS, L2_NULL_PTR);
+
+            /* loops and scopes outside the procedure are invisible in procedure body */
+            upper_loop_p = bytecode_p->loop_p;
+            upper_scope_depth = bytecode_p->scope_depth;
+            bytecode_p->loop_p = L2_NULL_PTR;
+            bytecode_p->scope_depth = 0;
+
+            l2_bytecode_compile_stmts(bytecode_p, stmt_p->u.procedure.body_p);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_RETURN, 0, L2_NULL_PTR);
+
+            bytecode_p->loop_p = upper_loop_p;
+            bytecode_p->scope_depth = upper_scope_depth;
+            l2_bytecode_patch_chain(bytecode_p, end_chain, l2_bytecode_pos(bytecode_p));
+            break;
+
+        case L2_AST_STMT_WHILE:
+            cond_pos = l2_bytecode_pos(bytecode_p);
+            end_chain = l2_bytecode_compile_cond(bytecode_p, stmt_p->u.loop.cond_p, stmt_p);
+            l2_bytecode_compile_loop_body(bytecode_p, stmt_p->u.loop.body_p, L2_SCOPE_TYPE_WHILE, &loop);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP, cond_pos, L2_NULL_PTR);
+
+            l2_bytecode_patch_chain(bytecode_p, loop.continue_chain, cond_pos);
+            l2_bytecode_patch_chain(bytecode_p, end_chain, l2_bytecode_pos(bytecode_p));
+            l2_bytecode_patch_chain(bytecode_p, loop.break_chain, l2_bytecode_pos(bytecode_p));
+            break;
+
+        case L2_AST_STMT_DO_WHILE:
+            next_pos = l2_bytecode_pos(bytecode_p);
+            l2_bytecode_compile_loop_body(bytecode_p, stmt_p->u.loop.body_p, L2_SCOPE_TYPE_DO_WHILE, &loop);
+
+            l2_bytecode_patch_chain(bytecode_p, loop.continue_chain, l2_bytecode_pos(bytecode_p));
+            end_chain = l2_bytecode_compile_cond(bytecode_p, stmt_p->u.loop.cond_p, stmt_p);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP, next_pos, L2_NULL_PTR);
+
+            l2_bytecode_patch_chain(bytecode_p, end_chain, l2_bytecode_pos(bytecode_p));
+            l2_bytecode_patch_chain(bytecode_p, loop.break_chain, l2_bytecode_pos(bytecode_p));
+            break;
+
+        case L2_AST_STMT_FOR:
+            /* the variables defined in the first expr are visible in the whole for-loop */
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_ENTER_SCOPE, L2_SCOPE_TYPE_COMMON, L2_NULL_PTR);
+            bytecode_p->scope_depth += 1;
+
+            if (stmt_p->u.for_loop.init_p)
+                l2_bytecode_compile_stmt(bytecode_p, stmt_p->u.for_loop.init_p);
+
+            cond_pos = l2_bytecode_pos(bytecode_p);
+            end_chain = L2_BYTECODE_NO_POS;
+            if (stmt_p->u.for_loop.cond_p) /* empty condition means true */
+                end_chain = l2_bytecode_compile_cond(bytecode_p, stmt_p->u.for_loop.cond_p, stmt_p);
+
+            l2_bytecode_compile_loop_body(bytecode_p, stmt_p->u.for_loop.body_p, L2_SCOPE_TYPE_FOR, &loop);
+
+            l2_bytecode_patch_chain(bytecode_p, loop.continue_chain, l2_bytecode_pos(bytecode_p));
+            if (stmt_p->u.for_loop.step_p) {
+                l2_bytecode_compile_expr(bytecode_p, stmt_p->u.for_loop.step_p);
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_POP, 0, L2_NULL_PTR);
+            }
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP, cond_pos, L2_NULL_PTR);
+
+            /* when run over the for-loop, the initialization scope should be destroyed */
+            l2_bytecode_patch_chain(bytecode_p, end_chain, l2_bytecode_pos(bytecode_p));
+            l2_bytecode_patch_chain(bytecode_p, loop.break_chain, l2_bytecode_pos(bytecode_p));
+            bytecode_p->scope_depth -= 1;
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_LEAVE_SCOPE, 0, L2_NULL_PTR);
+            break;
+
+        case L2_AST_STMT_BREAK:
+            bytecode_p->loop_p->break_chain = l2_bytecode_emit_loop_jump(bytecode_p, bytecode_p->loop_p->break_chain);
+            break;
+
+        case L2_AST_STMT_CONTINUE:
+            bytecode_p->loop_p->continue_chain = l2_bytecode_emit_loop_jump(bytecode_p, bytecode_p->loop_p->continue_chain);
+            break;
+
+        case L2_AST_STMT_RETURN:
+            /* the scopes inside procedure are destroyed along with the procedure scope */
+            if (stmt_p->u.stmt_expr.expr_p && stmt_p->u.stmt_expr.expr_p->type == L2_AST_EXPR_CALL) {
+                /* the callee of tail call returns to the caller of current procedure directly,
+                 * the value is returned by the next instruction only if it is called as usual
+                 * */
+                l2_bytecode_compile_args(bytecode_p, stmt_p->u.stmt_expr.expr_p);
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_TAIL_CALL, stmt_p->u.stmt_expr.expr_p->u.call.args_count, stmt_p->u.stmt_expr.expr_p);
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_RETURN_VAL, 0, L2_NULL_PTR);
+
+            } else if (stmt_p->u.stmt_expr.expr_p) {
+                l2_bytecode_compile_expr(bytecode_p, stmt_p->u.stmt_expr.expr_p);
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_RETURN_VAL, 0, L2_NULL_PTR);
+            } else {
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_RETURN, 0, L2_NULL_PTR);
+            }
+            break;
+
+        case L2_AST_STMT_IF:
+            /* the branches of if..elif..else are checked one by one */
+            end_chain = L2_BYTECODE_NO_POS;
+            while (stmt_p && stmt_p->type == L2_AST_STMT_IF) {
+                next_pos = l2_bytecode_compile_cond(bytecode_p, stmt_p->u.branch.cond_p, stmt_p);
+                l2_bytecode_compile_scope_stmts(bytecode_p, stmt_p->u.branch.then_p, L2_SCOPE_TYPE_COMMON);
+                end_chain = l2_bytecode_emit(bytecode_p, L2_BYTECODE_JUMP, end_chain, L2_NULL_PTR);
+                l2_bytecode_patch_chain(bytecode_p, next_pos, l2_bytecode_pos(bytecode_p));
+
+                stmt_p = stmt_p->u.branch.else_p;
+            }
+
+            if (stmt_p) /* else */
+                l2_bytecode_compile_stmt(bytecode_p, stmt_p);
+
+            l2_bytecode_patch_chain(bytecode_p, end_chain, l2_bytecode_pos(bytecode_p));
+            break;
+
+        case L2_AST_STMT_VAR:
+            for (def_p = stmt_p->u.var.defs_p; def_p; def_p = def_p->next_p) {
+                l2_bytecode_emit(bytecode_p, L2_BYTECODE_DEFINE_VAR, 0, def_p);
+
+                if (def_p->u.var_def.init_p) { /* with initialization */
+                    l2_bytecode_compile_expr(bytecode_p, def_p->u.var_def.init_p);
+                    l2_bytecode_emit(bytecode_p, L2_BYTECODE_INIT_VAR, 0, def_p);
+                }
+            }
+            break;
+
+        case L2_AST_STMT_EMPTY:
+            /* empty stmt which has only single ; */
+            break;
+
+        case L2_AST_STMT_EXPR:
+            l2_bytecode_compile_expr(bytecode_p, stmt_p->u.stmt_expr.expr_p);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_POP, 0, L2_NULL_PTR);
+            break;
+
+        case L2_AST_STMT_EVAL:
+            l2_bytecode_compile_expr(bytecode_p, stmt_p->u.stmt_expr.expr_p);
+            l2_bytecode_emit(bytecode_p, L2_BYTECODE_EVAL, 0, stmt_p);
+            break;
+
+        default:
+            l2_internal_error(L2_INTERNAL_ERROR_UNREACHABLE_CODE, "无效的语句节点");
+    }
+}
+
+/* compile stmts into the tail of bytecode, returns the position where they begin,
+ * the instructions compiled before stay valid, so that the procedures defined by them could be still called
+ * */
+int l2_bytecode_compile(l2_bytecode *bytecode_p, l2_ast_node *stmts_p) {
+    int entry_pos = l2_bytecode_pos(bytecode_p);
+
+    l2_bytecode_compile_stmts(bytecode_p, stmts_p);
+    l2_bytecode_emit(bytecode_p, L2_BYTECODE_HALT, 0, L2_NULL_PTR);
+    return entry_pos;
+}
+
+/* drop the instructions from pos, which are not referred by any procedure */
+void l2_bytecode_rollback(l2_bytecode *bytecode_p, int pos) {
+    bytecode_p->inst_vec.size = pos;
+}
@@ -0,0 +1,100 @@
+#ifndef _L2_BYTECODE_H_
+#define _L2_BYTECODE_H_
+
+#include "../l2_tpl/l2_vector.h"
+#include "l2_ast.h"
+
+#define L2_BYTECODE_NO_POS (-1) /* the end of the chain of jumps which wait to be patched */
+
+typedef enum _l2_bytecode_opcode {
+    /* operand stack */
+    L2_BYTECODE_PUSH_INTEGER, /* push u.integer */
+    L2_BYTECODE_PUSH_REAL, /* push u.real */
+    L2_BYTECODE_PUSH_BOOL, /* push u.bool */
+    L2_BYTECODE_POP, /* discard the top of operand stack */
+
+    /* expr, the ast node of expr is referenced for its operator, identifier and error position */
+    L2_BYTECODE_LOAD, /* push the value of identifier u.node_p */
+    L2_BYTECODE_ASSIGN, /* pop the right value, assign it and push the result */
+    L2_BYTECODE_DUALISTIC, /* pop two operands and push the result */
+    L2_BYTECODE_UNITARY, /* pop one operand and push the result */
+
+    /* the operations performed inline if both operands are integer, otherwise they are performed as DUALISTIC */
+    L2_BYTECODE_ADD, /* + */
+    L2_BYTECODE_SUB, /* - */
+    L2_BYTECODE_MUL, /* * */
+    L2_BYTECODE_DIV, /* / */
+    L2_BYTECODE_MOD, /* % */
+    L2_BYTECODE_BIT_AND, /* & */
+    L2_BYTECODE_BIT_XOR, /* ^ */
+    L2_BYTECODE_BIT_OR, /* | */
+    L2_BYTECODE_LSHIFT, /* << */
+    L2_BYTECODE_RSHIFT, /* >> */
+    L2_BYTECODE_EQUAL, /* == */
+    L2_BYTECODE_NOT_EQUAL, /* != */
+    L2_BYTECODE_GREAT_THAN, /* > */
+    L2_BYTECODE_GREAT_EQUAL_THAN, /* >= */
+    L2_BYTECODE_LESS_THAN, /* < */
+    L2_BYTECODE_LESS_EQUAL_THAN, /* <= */
+
+    /* the identifier resolved, the symbol is addressed by addr directly, and u.node_p is reported if it is not defined or has no value */
+    L2_BYTECODE_LOAD_ADDR, /* push the value of symbol */
+    L2_BYTECODE_STORE_ADDR, /* store the top value into symbol ( by = ), the value is kept as the result */
+
+    L2_BYTECODE_CALL, /* pop arg values and call procedure u.node_p */
+    L2_BYTECODE_TAIL_CALL, /* pop arg values and call procedure u.node_p with the current frame, or call it as usual if the frame could not be reused */
+
+    /* stmt */
+    L2_BYTECODE_DEFINE_VAR, /* allocate the variable u.node_p in current scope */
+    L2_BYTECODE_INIT_VAR, /* pop the initial value of variable u.node_p */
+    L2_BYTECODE_DEFINE_PROCEDURE, /* define the procedure u.node_p which begins at arg */
+    L2_BYTECODE_EVAL, /* pop and print the value */
+    L2_BYTECODE_RETURN, /* return without value */
+    L2_BYTECODE_RETURN_VAL, /* pop and return the value */
+
+    /* scope */
+    L2_BYTECODE_ENTER_SCOPE, /* create a sub scope which type is arg */
+    L2_BYTECODE_LEAVE_SCOPE, /* escape from current scope */
+
+    /* control flow */
+    L2_BYTECODE_JUMP, /* jump to arg */
+    L2_BYTECODE_JUMP_IF_FALSE, /* pop a bool, jump to arg if it is false, u.node_p is reported if it is not bool */
+    L2_BYTECODE_SHORT_CIRCUIT, /* jump to arg if the top operand decides the result of u.node_p ( && or || ), the operand is kept */
+    L2_BYTECODE_HALT /* stop running */
+
+}l2_bytecode_opcode;
+
+typedef struct _l2_bytecode_inst {
+    l2_bytecode_opcode opcode;
+    int arg;
+    union {
+        int64_t integer;
+        double real;
+        boolean bool;
+        l2_ast_node *node_p;
+    }u;
+    l2_ast_addr addr; /* the address of identifier in LOAD_ADDR and STORE_ADDR */
+}l2_bytecode_inst;
+
+L2_VECTOR_DEFINE(l2_bytecode_inst)
+
+typedef struct _l2_bytecode_loop {
+    struct _l2_bytecode_loop *upper_p;
+    int scope_depth; /* the scope depth inside the loop body */
+    int break_chain; /* the chains of jumps which wait to be patched with the end and continue position */
+    int continue_chain;
+}l2_bytecode_loop;
+
+typedef struct _l2_bytecode {
+    l2_bytecode_inst_vector inst_vec; /* all of the compiled instructions, stay alive until the bytecode is destroyed */
+    l2_bytecode_loop *loop_p; /* the innermost loop of the current compiling position ( inside current procedure ) */
+    int scope_depth; /* the count of scopes entered at the current compiling position ( inside current procedure ) */
+}l2_bytecode;
+
+l2_bytecode *l2_bytecode_create();
+void l2_bytecode_destroy(l2_bytecode *bytecode_p);
+
+int l2_bytecode_compile(l2_bytecode *bytecode_p, l2_ast_node *stmts_p);
+void l2_bytecode_rollback(l2_bytecode *bytecode_p, int pos);
+
+#endif
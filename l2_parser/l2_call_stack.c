@@ -1,27 +1,55 @@
 #include "l2_call_stack.h"
 #include "l2_parse.h"
+#include "../l2_drv/l2_error.h"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
 
 extern l2_parser *g_parser_p;
 
-l2_call_stack *l2_call_stack_create() {
+/* 3/4 of the host stack is used, the rest is left for the deepest expr and the error handling */
+size_t l2_call_stack_host_limit() {
+#if !defined(_WIN32)
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_STACK, &rl) == 0) {
+        if (rl.rlim_cur == RLIM_INFINITY) return L2_CALL_STACK_HOST_NO_LIMIT;
+        return rl.rlim_cur / 4 * 3;
+    }
+#endif
+    return L2_CALL_STACK_HOST_STACK_SIZE;
+}
+
+l2_call_stack *l2_call_stack_create(int max_depth) {
     l2_call_stack *call_stack_p;
     call_stack_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_call_stack));
-    l2_stack_create(&call_stack_p->stack, sizeof(l2_call_frame));
+    l2_call_frame_stack_create(&call_stack_p->stack);
+    call_stack_p->max_depth = max_depth;
+    call_stack_p->host_base = (size_t)&call_stack_p;
+    call_stack_p->host_limit = l2_call_stack_host_limit();
 
     return call_stack_p;
 }
 
 void l2_call_stack_destroy(l2_call_stack *call_stack_p) {
-    l2_stack_destroy(&call_stack_p->stack);
+    l2_call_frame_stack_destroy(&call_stack_p->stack);
     l2_storage_mem_delete(g_parser_p->storage_p, call_stack_p);
 }
 
-void l2_call_stack_push_frame(l2_call_stack *call_stack_p, l2_call_frame call_frame) {
-    l2_stack_push_back(&call_stack_p->stack, &call_frame);
+/* the frame is pushed before entering procedure, the depth of calls is limited by both the max depth and the host stack */
+void l2_call_stack_push_frame(l2_call_stack *call_stack_p, l2_call_frame call_frame, int err_line, int err_col) {
+    size_t host_top = (size_t)&call_frame;
+
+    if (call_stack_p->stack.size >= (l2_stack_size)call_stack_p->max_depth
+        || (call_stack_p->host_limit != L2_CALL_STACK_HOST_NO_LIMIT
+            && host_top < call_stack_p->host_base && call_stack_p->host_base - host_top > call_stack_p->host_limit))
+        l2_parsing_error(L2_PARSING_ERROR_CALL_STACK_OVERFLOW, err_line, err_col, call_stack_p->stack.size);
+
+    l2_call_frame_stack_push_back(&call_stack_p->stack, call_frame);
 }
 
 l2_call_frame l2_call_stack_pop_frame(l2_call_stack *call_stack_p) {
-    return *(l2_call_frame *)l2_stack_pop(&call_stack_p->stack);
+    return *l2_call_frame_stack_pop(&call_stack_p->stack);
 }
 
 int l2_call_stack_size(l2_call_stack *call_stack_p) {
@@ -29,6 +57,31 @@ int l2_call_stack_size(l2_call_stack *call_stack_p) {
 }
 
 l2_call_frame l2_call_stack_top_frame(l2_call_stack *call_stack_p) {
-    return *(l2_call_frame *)l2_stack_back(&call_stack_p->stack);
+    return *l2_call_frame_stack_back(&call_stack_p->stack);
+}
+
+/* the frame of current procedure could be reused by the tail call in scope_p, only if neither the callee nor the procedures
+ * passed as real parameters are defined inside current procedure, whose scope is escaped before the callee runs
+ * */
+boolean l2_call_stack_could_reuse_frame(l2_call_stack *call_stack_p, l2_scope *scope_p, l2_procedure *procedure_p, l2_expr_info *args_p, int args_count) {
+    l2_scope *procedure_scope_p;
+    int i;
+
+    if (call_stack_p->stack.size == 0) return L2_FALSE;
+    if (!(procedure_scope_p = l2_scope_find_nearest_scope_by_type(scope_p, L2_SCOPE_TYPE_PROCEDURE))) return L2_FALSE;
+
+    /* the scopes inside current procedure are deeper than it */
+    if (procedure_p->upper_scope_p->level >= procedure_scope_p->level) return L2_FALSE;
+
+    for (i = 0; i < args_count; i++) {
+        if (args_p[i].val_type == L2_EXPR_VAL_TYPE_PROCEDURE && args_p[i].val.procedure.upper_scope_p->level >= procedure_scope_p->level)
+            return L2_FALSE;
+    }
+
+    return L2_TRUE;
 }
 
+/* the top frame is taken over by the callee of tail call, the return position and the scope of caller are kept */
+void l2_call_stack_reuse_frame(l2_call_stack *call_stack_p, l2_scope *procedure_scope_p) {
+    l2_call_frame_stack_back(&call_stack_p->stack)->procedure_scope_p = procedure_scope_p;
+}
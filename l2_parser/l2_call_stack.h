@@ -3,27 +3,41 @@
 
 #include "../l2_tpl/l2_stack.h"
 #include "l2_symbol_table.h"
+#include "l2_eval.h"
+
+#define L2_CALL_STACK_MAX_DEPTH 100000 /* the default max depth of procedure calls */
+#define L2_CALL_STACK_HOST_STACK_SIZE (768 * 1024) /* the host stack which could be used by the token engine if the limit of system is unknown, the main thread has 1 MB on windows */
+#define L2_CALL_STACK_HOST_NO_LIMIT 0 /* the host stack is unlimited, it is not checked */
 
 typedef struct _l2_param_list {
-    l2_vector expr_info_vec; /* l2_symbol vector */
+    l2_expr_info_vector expr_info_vec;
 }l2_param_list;
 
 typedef struct _l2_call_frame {
     int ret_pos;
     l2_param_list param_list;
+    l2_scope *ret_scope_p; /* the scope of caller, it is restored when procedure returns ( vm ) */
+    l2_scope *procedure_scope_p; /* the scope created for this call ( vm ) */
 }l2_call_frame;
 
+L2_STACK_DEFINE(l2_call_frame)
+
 typedef struct _l2_call_stack {
-    l2_stack stack;
+    l2_call_frame_stack stack;
+    int max_depth;
+    size_t host_base; /* the address of host stack when call stack is created */
+    size_t host_limit; /* the size of host stack which could be used, the token engine calls procedure by host recursion */
 }l2_call_stack;
 
-l2_call_stack *l2_call_stack_create();
+l2_call_stack *l2_call_stack_create(int max_depth);
 void l2_call_stack_destroy(l2_call_stack *call_stack_p);
 
-void l2_call_stack_push_frame(l2_call_stack *call_stack_p, l2_call_frame call_frame);
+void l2_call_stack_push_frame(l2_call_stack *call_stack_p, l2_call_frame call_frame, int err_line, int err_col);
 l2_call_frame l2_call_stack_pop_frame(l2_call_stack *call_stack_p);
 l2_call_frame l2_call_stack_top_frame(l2_call_stack *call_stack_p);
 int l2_call_stack_size(l2_call_stack *call_stack_p);
+boolean l2_call_stack_could_reuse_frame(l2_call_stack *call_stack_p, l2_scope *scope_p, l2_procedure *procedure_p, l2_expr_info *args_p, int args_count);
+void l2_call_stack_reuse_frame(l2_call_stack *call_stack_p, l2_scope *procedure_scope_p);
 
 
 
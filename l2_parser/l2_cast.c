@@ -7,45 +7,78 @@
 #include "../l2_tpl/l2_vector.h"
 #include "../l2_tpl/l2_stack.h"
 
-int l2_cast_hex_str_to_int(const char *s) {
-    l2_assert(s, L2_INTERNAL_ERROR_NULL_POINTER);
-    const char *p;
-    int ans = 0, n = strlen(s), digit = 0, factor;
-    for (p = s; *p != '\0'; p++) {
-        l2_pow(factor, 8, n - 1);
-        if (*p >= '0' && *p <= '9') {
-            digit = *p - '0';
-        } else if (*p >= 'a' && *p <= 'f') {
-            digit = *p - 'a' + 10;
-        } else if (*p >= 'A' && *p <= 'F') {
-            digit = *p - 'A' + 10;
-        }
-        ans += factor * digit;
-        n -= 1;
-    }
-    return ans;
+#define l2_cast_hex_digit(c) ((c) <= '9' ? (c) - '0' : ((c) | 0x20) - 'a' + 10)
+
+/* the digits of literal are converted in a single pass, the value out of range wraps around as uint64_t */
+int64_t l2_cast_hex_chars_to_int(const char *p, int len) {
+    uint64_t ans = 0;
+    int i;
+    l2_assert(p, L2_INTERNAL_ERROR_NULL_POINTER);
+    for (i = 0; i < len; i++)
+        ans = ans * 16 + l2_cast_hex_digit(p[i]);
+    return (int64_t)ans;
 }
 
-int l2_cast_octal_str_to_int(const char *s) {
-    l2_assert(s, L2_INTERNAL_ERROR_NULL_POINTER);
-    const char *p;
-    int ans = 0, n = strlen(s), factor;
-    for (p = s; *p != '\0'; p++) {
-        l2_pow(factor, 8, n - 1);
-        ans += factor * (*p - '0');
-        n -= 1;
-    }
-    return ans;
+int64_t l2_cast_octal_chars_to_int(const char *p, int len) {
+    uint64_t ans = 0;
+    int i;
+    l2_assert(p, L2_INTERNAL_ERROR_NULL_POINTER);
+    for (i = 0; i < len; i++)
+        ans = ans * 8 + (p[i] - '0');
+    return (int64_t)ans;
 }
 
-int l2_cast_decimal_str_to_int(const char *s) {
-    l2_assert(s, L2_INTERNAL_ERROR_NULL_POINTER);
-    return strtol(s, L2_NULL_PTR, 10);
+int64_t l2_cast_decimal_chars_to_int(const char *p, int len) {
+    uint64_t ans = 0;
+    int i;
+    l2_assert(p, L2_INTERNAL_ERROR_NULL_POINTER);
+    for (i = 0; i < len; i++)
+        ans = ans * 10 + (p[i] - '0');
+    return (int64_t)ans;
 }
 
-double l2_cast_real_str_to_int(const char *s) {
-    l2_assert(s, L2_INTERNAL_ERROR_NULL_POINTER);
-    return strtod(s, L2_NULL_PTR);
+/* the powers of 10 which are exactly represented by double */
+static const double g_l2_cast_exact_powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define L2_CAST_MAX_EXACT_MANTISSA (1ULL << 53)
+#define L2_CAST_MAX_MANTISSA_DIGITS 19
+#define L2_CAST_REAL_BUFF_SIZE 64
+
+/* the real literal ( digits.digits ), if the digits as integer and the power of 10 of fraction are both exact in double,
+ * the result of a single division is correctly rounded, otherwise it is converted by strtod
+ * */
+double l2_cast_real_chars_to_real(const char *p, int len) {
+    uint64_t mantissa = 0;
+    int i, digits = 0, frac_digits = 0;
+    boolean is_frac = L2_FALSE;
+    char buff[L2_CAST_REAL_BUFF_SIZE], *str_p;
+    double ans;
+
+    l2_assert(p, L2_INTERNAL_ERROR_NULL_POINTER);
+    for (i = 0; i < len; i++) {
+        if (p[i] == '.') {
+            is_frac = L2_TRUE;
+            continue;
+        }
+        if (mantissa || p[i] != '0') digits += 1; /* the leading zeros are not counted */
+        if (digits > L2_CAST_MAX_MANTISSA_DIGITS) break;
+        mantissa = mantissa * 10 + (p[i] - '0');
+        if (is_frac) frac_digits += 1;
+    }
+
+    if (i == len && mantissa <= L2_CAST_MAX_EXACT_MANTISSA && frac_digits <= 22)
+        return (double)mantissa / g_l2_cast_exact_powers_of_ten[frac_digits];
+
+    str_p = len < L2_CAST_REAL_BUFF_SIZE ? buff : malloc(len + 1);
+    l2_assert(str_p, L2_INTERNAL_ERROR_NULL_POINTER);
+    memcpy(str_p, p, len);
+    str_p[len] = '\0';
+    ans = strtod(str_p, L2_NULL_PTR);
+    if (str_p != buff) free(str_p);
+    return ans;
 }
 
 void l2_cast_decimal_to_str(int dec_num, char *s) {
@@ -63,7 +96,7 @@ l2_stack l2_cast_vector_to_stack(l2_vector *vec_p) {
     l2_stack stack;
     l2_stack_create(&stack, vec_p->single_size);
     int i;
-    for (i = 0; i < vec_p->size; i++) {
+    for (i = 0; i < (int)vec_p->size; i++) {
         l2_stack_push_back(&stack, l2_vector_at(vec_p, i));
     }
     return stack;
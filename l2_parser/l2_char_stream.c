@@ -1,63 +1,242 @@
 #include "stdlib.h"
 #include "stdio.h"
+#include "string.h"
 #include "l2_char_stream.h"
 
 #include "../l2_tpl/l2_common_type.h"
 #include "../l2_drv/l2_assert.h"
-#include "../l2_tpl/l2_vector.h"
 #include "l2_parse.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 extern l2_parser *g_parser_p;
 
+#define l2_char_is_id(c) (((c) >= 'A' && (c) <= 'Z') || ((c) >= 'a' && (c) <= 'z') || (c) == '_' || ((c) >= '0' && (c) <= '9'))
+#define l2_char_is_digit(c) ((c) >= '0' && (c) <= '9')
+
+/* reserve the buffer so that at least min_free_size chars could be read into it */
+void l2_char_stream_reserve(l2_char_stream *char_stream_p, int min_free_size) {
+    int max_size = char_stream_p->chars_max_size;
+
+    if (char_stream_p->chars_size + min_free_size <= max_size) return;
+    while (char_stream_p->chars_size + min_free_size > max_size) max_size *= 2;
+
+    char_stream_p->chars_p = l2_storage_mem_renew(g_parser_p->storage_p, char_stream_p->chars_p, max_size);
+    char_stream_p->chars_max_size = max_size;
+}
+
+/* read next block of source into buffer, returns the count of chars read */
+int l2_char_stream_fill(l2_char_stream *char_stream_p) {
+    char *free_p;
+    int read_size;
+
+    /* nothing more to read, so the buffer is not grown for it */
+    if (feof(char_stream_p->fp)) return 0;
+
+    l2_char_stream_reserve(char_stream_p, L2_CHAR_STREAM_BLOCK_SIZE);
+    free_p = char_stream_p->chars_p + char_stream_p->chars_size;
+
+    if (char_stream_p->fp == stdin && g_parser_p->is_repl) {
+        if (!fgets(free_p, char_stream_p->chars_max_size - char_stream_p->chars_size, stdin)) return 0;
+        read_size = strlen(free_p);
+    } else {
+        read_size = fread(free_p, 1, char_stream_p->chars_max_size - char_stream_p->chars_size, char_stream_p->fp);
+    }
+
+    char_stream_p->chars_size += read_size;
+    return read_size;
+}
+
 l2_char_stream *l2_char_stream_create(FILE *fp) {
+    long file_size = -1;
 
     l2_assert(fp, L2_INTERNAL_ERROR_NULL_POINTER);
     l2_char_stream *char_stream_p = malloc(sizeof(l2_char_stream));
     char_stream_p->fp = fp;
     char_stream_p->cols = 0;
     char_stream_p->lines = 1;
-    l2_vector_create(&char_stream_p->chars_vector, sizeof(char));
-    char_stream_p->chars_vector_current_pos = 0;
+
+    /* the whole file is read by a single block if its size is known */
+    if (fp != stdin && fseek(fp, 0, SEEK_END) == 0) {
+        file_size = ftell(fp);
+        rewind(fp);
+    }
+
+    char_stream_p->chars_size = 0;
+    char_stream_p->chars_max_size = file_size >= 0 ? file_size + 1 : L2_CHAR_STREAM_BLOCK_SIZE;
+    char_stream_p->chars_p = l2_storage_mem_new(g_parser_p->storage_p, char_stream_p->chars_max_size);
+    char_stream_p->chars_current_pos = 0;
+    char_stream_p->chars_counted_pos = 0;
+    char_stream_p->chars_base = 0;
+    char_stream_p->chars_released = 0;
+    char_stream_p->release_pos = 0;
+    char_stream_p->is_eof_read = L2_FALSE;
+
+    char_stream_p->line_starts_max_count = L2_CHAR_STREAM_INIT_LINE_STARTS_MAX_COUNT;
+    char_stream_p->line_starts_p = l2_storage_mem_new(g_parser_p->storage_p, char_stream_p->line_starts_max_count * sizeof(int));
+    char_stream_p->line_starts_p[0] = 0;
+    char_stream_p->lines_base = 0;
+    char_stream_p->line_hint = 1;
     return char_stream_p;
 }
 
 void l2_char_stream_destroy(l2_char_stream *char_stream_p) {
     l2_assert(char_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    l2_vector_destroy(&char_stream_p->chars_vector);
+    l2_storage_mem_delete(g_parser_p->storage_p, char_stream_p->chars_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, char_stream_p->line_starts_p);
     if (char_stream_p->fp != stdin)
         fclose(char_stream_p->fp);
     free(char_stream_p);
 }
 
-char l2_char_stream_next_char(l2_char_stream *char_stream_p) {
-    l2_assert(char_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-
-    if (char_stream_p->chars_vector_current_pos < char_stream_p->chars_vector.size) {
-        char_stream_p->chars_vector_current_pos += 1;
-        return *(char *)l2_vector_at(&char_stream_p->chars_vector, char_stream_p->chars_vector_current_pos - 1);
+/* the pos is in buffer */
+void l2_char_stream_add_line_start(l2_char_stream *char_stream_p, int pos) {
+    if (char_stream_p->lines - char_stream_p->lines_base >= char_stream_p->line_starts_max_count) {
+        char_stream_p->line_starts_max_count *= 2;
+        char_stream_p->line_starts_p = l2_storage_mem_renew(g_parser_p->storage_p, char_stream_p->line_starts_p, char_stream_p->line_starts_max_count * sizeof(int));
     }
+    char_stream_p->line_starts_p[char_stream_p->lines - char_stream_p->lines_base] = char_stream_p->chars_base + pos;
+    char_stream_p->lines += 1;
+}
 
+char l2_char_stream_next_char(l2_char_stream *char_stream_p) {
     char ch;
-    if(!fread(&ch, 1, 1, char_stream_p->fp)) {
+
+    if (char_stream_p->chars_current_pos >= char_stream_p->chars_size && !l2_char_stream_fill(char_stream_p)) {
+        char_stream_p->is_eof_read = L2_TRUE;
         return L2_EOF;
     }
 
-    if (ch == '\n') {
-        char_stream_p->lines += 1;
-        char_stream_p->cols = 0;
-    } else {
-        char_stream_p->cols += 1;
+    char_stream_p->is_eof_read = L2_FALSE;
+
+    ch = char_stream_p->chars_p[char_stream_p->chars_current_pos++];
+
+    if (char_stream_p->chars_current_pos > char_stream_p->chars_counted_pos) {
+        char_stream_p->chars_counted_pos = char_stream_p->chars_current_pos;
+
+        if (ch == '\n') {
+            l2_char_stream_add_line_start(char_stream_p, char_stream_p->chars_current_pos);
+            char_stream_p->cols = 0;
+        } else {
+            char_stream_p->cols += 1;
+        }
     }
 
-    l2_vector_append(&char_stream_p->chars_vector, &ch);
-    char_stream_p->chars_vector_current_pos += 1;
     return ch;
 }
 
+/* move the current position forward to pos ( in buffer ), the lines and cols are counted for the chars not counted yet */
+void l2_char_stream_forward_to(l2_char_stream *char_stream_p, int pos) {
+    char *p, *end_p;
+
+    if (pos > char_stream_p->chars_counted_pos) {
+        p = char_stream_p->chars_p + char_stream_p->chars_counted_pos;
+        end_p = char_stream_p->chars_p + pos;
+
+        while ((p = memchr(p, '\n', end_p - p))) {
+            p += 1;
+            l2_char_stream_add_line_start(char_stream_p, p - char_stream_p->chars_p);
+        }
+
+        char_stream_p->chars_counted_pos = pos;
+        char_stream_p->cols = char_stream_p->chars_base + pos - char_stream_p->line_starts_p[char_stream_p->lines - char_stream_p->lines_base - 1];
+    }
+
+    char_stream_p->chars_current_pos = pos;
+    char_stream_p->is_eof_read = L2_FALSE;
+}
+
+#if defined(__SSE2__)
+/* one bit for each of the 16 chars, which is set if the char is in the class */
+int l2_char_stream_class_mask(__m128i chars, l2_char_class char_class) {
+    __m128i mask, lower, digit;
+
+    digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+
+    switch (char_class) {
+        case L2_CHAR_CLASS_BLANK:
+            mask = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\r'))));
+            break;
+
+        case L2_CHAR_CLASS_ID:
+            /* the letters are compared in lower case, the chars which are not ascii are negative and never matched */
+            lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+            mask = _mm_or_si128(
+                    _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1))),
+                    _mm_or_si128(digit, _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'))));
+            break;
+
+        default:
+            mask = digit;
+    }
+
+    return _mm_movemask_epi8(mask);
+}
+#endif
+
+/* the count of chars in the class from current position, which have been read into buffer */
+int l2_char_stream_span(l2_char_stream *char_stream_p, l2_char_class char_class) {
+    char *begin_p = char_stream_p->chars_p + char_stream_p->chars_current_pos, *p = begin_p;
+    char *end_p = char_stream_p->chars_p + char_stream_p->chars_size;
+
+#if defined(__SSE2__)
+    int mask;
+    for (; end_p - p >= 16; p += 16) {
+        mask = l2_char_stream_class_mask(_mm_loadu_si128((__m128i *)p), char_class);
+        if (mask != 0xffff) return p - begin_p + __builtin_ctz(~mask);
+    }
+#endif
+
+    switch (char_class) {
+        case L2_CHAR_CLASS_BLANK: for (; p < end_p && l2_char_is_blank(*p); p++); break;
+        case L2_CHAR_CLASS_ID: for (; p < end_p && l2_char_is_id(*p); p++); break;
+        default: for (; p < end_p && l2_char_is_digit(*p); p++);
+    }
+    return p - begin_p;
+}
+
+void l2_char_stream_skip_blanks(l2_char_stream *char_stream_p) {
+    l2_char_stream_forward_to(char_stream_p, char_stream_p->chars_current_pos + l2_char_stream_span(char_stream_p, L2_CHAR_CLASS_BLANK));
+}
+
+/* skip the chars until the end of line, the '\n' is not skipped */
+void l2_char_stream_skip_line(l2_char_stream *char_stream_p) {
+    char *p;
+
+    while (1) {
+        p = memchr(char_stream_p->chars_p + char_stream_p->chars_current_pos, '\n', char_stream_p->chars_size - char_stream_p->chars_current_pos);
+        if (p) {
+            l2_char_stream_forward_to(char_stream_p, p - char_stream_p->chars_p);
+            return;
+        }
+
+        l2_char_stream_forward_to(char_stream_p, char_stream_p->chars_size);
+        if (!l2_char_stream_fill(char_stream_p)) return;
+    }
+}
+
+/* read the chars in the class from current position, returns the count of them,
+ * the chars are left in buffer just before the current position
+ * */
+int l2_char_stream_read_span(l2_char_stream *char_stream_p, l2_char_class char_class) {
+    int len = l2_char_stream_span(char_stream_p, char_class);
+    l2_char_stream_forward_to(char_stream_p, char_stream_p->chars_current_pos + len);
+    return len;
+}
+
 void l2_char_stream_rollback(l2_char_stream *char_stream_p) {
     l2_assert(char_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    l2_assert(char_stream_p->chars_vector_current_pos > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE);
-    char_stream_p->chars_vector_current_pos -= 1;
+    if (char_stream_p->is_eof_read) {
+        char_stream_p->is_eof_read = L2_FALSE;
+        return;
+    }
+
+    l2_assert(char_stream_p->chars_current_pos > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE);
+    char_stream_p->chars_current_pos -= 1;
 }
 
 int l2_char_stream_lines(const l2_char_stream *char_stream_p) {
@@ -70,4 +249,73 @@ int l2_char_stream_cols(const l2_char_stream *char_stream_p) {
     return char_stream_p->cols;
 }
 
+/* the pos is the count of chars read when the line and col are taken ( as lines and cols of the stream ),
+ * the lookups are mostly in order, so the line found last time is tried first
+ * */
+void l2_char_stream_get_line_col(l2_char_stream *char_stream_p, int pos, int *line_p, int *col_p) {
+    int *line_starts_p = char_stream_p->line_starts_p;
+    int count = char_stream_p->lines - char_stream_p->lines_base; /* the lines are counted from lines_base here */
+    int line = char_stream_p->line_hint - char_stream_p->lines_base, low, high, mid;
+
+    if (line < 1 || line > count || line_starts_p[line - 1] > pos || (line < count && line_starts_p[line] <= pos)) {
+        /* find the last line which starts before pos */
+        low = 1;
+        high = count;
+        while (low < high) {
+            mid = (low + high + 1) / 2;
+            if (line_starts_p[mid - 1] <= pos) low = mid;
+            else high = mid - 1;
+        }
+        line = low;
+        char_stream_p->line_hint = char_stream_p->lines_base + low;
+    }
+
+    *line_p = char_stream_p->lines_base + line;
+    *col_p = pos - line_starts_p[line - 1];
+}
+
+/* read the rest of source into buffer */
+void l2_char_stream_read_all(l2_char_stream *char_stream_p) {
+    while (l2_char_stream_fill(char_stream_p));
+}
 
+/* the line starts of the whole source are restored, and all of the chars are taken as read */
+void l2_char_stream_set_line_starts(l2_char_stream *char_stream_p, const int *line_starts_p, int lines) {
+    if (lines > char_stream_p->line_starts_max_count) {
+        char_stream_p->line_starts_max_count = lines;
+        char_stream_p->line_starts_p = l2_storage_mem_renew(g_parser_p->storage_p, char_stream_p->line_starts_p, lines * sizeof(int));
+    }
+    memcpy(char_stream_p->line_starts_p, line_starts_p, lines * sizeof(int));
+    char_stream_p->lines = lines;
+    char_stream_p->line_hint = 1;
+
+    char_stream_p->chars_current_pos = char_stream_p->chars_counted_pos = char_stream_p->chars_size;
+    char_stream_p->cols = char_stream_p->chars_size - char_stream_p->line_starts_p[lines - 1];
+}
+
+/* move the released chars out of buffer, with the line starts before the line of release pos */
+void l2_char_stream_compact(l2_char_stream *char_stream_p) {
+    int read_size = char_stream_p->chars_released, line, col;
+
+    memmove(char_stream_p->chars_p, char_stream_p->chars_p + read_size, char_stream_p->chars_size - read_size);
+    char_stream_p->chars_size -= read_size;
+    char_stream_p->chars_current_pos -= read_size;
+    char_stream_p->chars_counted_pos -= read_size;
+    char_stream_p->chars_base += read_size;
+    char_stream_p->chars_released = 0;
+
+    l2_char_stream_get_line_col(char_stream_p, char_stream_p->release_pos, &line, &col);
+    memmove(char_stream_p->line_starts_p, char_stream_p->line_starts_p + (line - 1 - char_stream_p->lines_base), (char_stream_p->lines - line + 1) * sizeof(int));
+    char_stream_p->lines_base = line - 1;
+}
+
+/* release the chars which have been read, and the line starts before the line of pos ( the first pos to be looked up later ),
+ * they are only marked as released, and moved out when the buffer is full or half released, so that the rest of block is not moved after each stmt
+ * */
+void l2_char_stream_release(l2_char_stream *char_stream_p, int pos) {
+    char_stream_p->chars_released = char_stream_p->chars_current_pos;
+    char_stream_p->release_pos = pos;
+
+    if (char_stream_p->chars_size == char_stream_p->chars_max_size || char_stream_p->chars_released * 2 >= char_stream_p->chars_max_size)
+        l2_char_stream_compact(char_stream_p);
+}
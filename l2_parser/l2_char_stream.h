@@ -4,14 +4,37 @@
 #include <stdio.h>
 
 #include "../l2_tpl/l2_common_type.h"
-#include "../l2_tpl/l2_vector.h"
 
+#define L2_CHAR_STREAM_BLOCK_SIZE 65536
+#define L2_CHAR_STREAM_INIT_LINE_STARTS_MAX_COUNT 64
+
+typedef enum _l2_char_class {
+    L2_CHAR_CLASS_BLANK,
+    L2_CHAR_CLASS_ID, /* the chars in identifier */
+    L2_CHAR_CLASS_DIGIT
+}l2_char_class;
+
+/* the source is read into chars buffer by blocks ( by lines for repl, so that it is not blocked ),
+ * and the lexer reads the chars straight out of the buffer,
+ * the positions of tokens and line starts count from the beginning of source, which includes the chars released
+ * */
 typedef struct _l2_char_stream {
     FILE *fp;
     int lines;
     int cols;
-    l2_vector chars_vector;
-    int chars_vector_current_pos;
+    char *chars_p;
+    int chars_size;
+    int chars_max_size;
+    int chars_current_pos;
+    int chars_base; /* the count of chars moved out before the buffer */
+    int chars_released; /* the chars before it in buffer have been released, they are moved out when the buffer is full or half released */
+    int release_pos; /* the first pos to be looked up after the release, the line starts before its line are moved out with the chars */
+    boolean is_eof_read; /* the last char read is EOF, which takes no place in buffer, so rollback of it does not move */
+    int chars_counted_pos; /* the lines and cols have been counted until here, the chars read again after rollback are not counted */
+    int *line_starts_p; /* the position where each line starts, the count of them is lines - lines_base */
+    int line_starts_max_count;
+    int lines_base; /* the count of line starts released */
+    int line_hint; /* the line found by last lookup */
 }l2_char_stream;
 
 l2_char_stream *l2_char_stream_create(FILE *fp);
@@ -21,6 +44,13 @@ char l2_char_stream_next_char(l2_char_stream *char_stream_p);
 void l2_char_stream_rollback(l2_char_stream *char_stream_p);
 int l2_char_stream_lines(const l2_char_stream *char_stream_p);
 int l2_char_stream_cols(const l2_char_stream *char_stream_p);
+void l2_char_stream_read_all(l2_char_stream *char_stream_p);
+void l2_char_stream_set_line_starts(l2_char_stream *char_stream_p, const int *line_starts_p, int lines);
+void l2_char_stream_skip_blanks(l2_char_stream *char_stream_p);
+void l2_char_stream_skip_line(l2_char_stream *char_stream_p);
+int l2_char_stream_read_span(l2_char_stream *char_stream_p, l2_char_class char_class);
+void l2_char_stream_get_line_col(l2_char_stream *char_stream_p, int pos, int *line_p, int *col_p);
+void l2_char_stream_release(l2_char_stream *char_stream_p, int pos);
 
 
 
@@ -31,7 +31,7 @@ boolean l2_eval_update_symbol_bool(l2_scope *scope_p, char *symbol_name, boolean
     return L2_TRUE;
 }
 
-boolean l2_eval_update_symbol_integer(l2_scope *scope_p, char *symbol_name, int integer) {
+boolean l2_eval_update_symbol_integer(l2_scope *scope_p, char *symbol_name, int64_t integer) {
     l2_symbol_node *symbol_node_p = l2_eval_get_symbol_node(scope_p, symbol_name);
     if (!symbol_node_p) return L2_FALSE;
     symbol_node_p->symbol.type = L2_SYMBOL_TYPE_INTEGER;
@@ -115,7 +115,6 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
     l2_token *left_id_p;
     l2_expr_info right_expr_info, res_expr_info;
     l2_symbol_node *left_symbol_p;
-    l2_token *token_opr_p;
     int opr_err_line, opr_err_col;
     int id_err_line, id_err_col;
     boolean symbol_updated = L2_TRUE;
@@ -123,7 +122,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
     _if_type (L2_TOKEN_IDENTIFIER)
     {
         left_id_p = l2_parse_token_current();
-        char *id_str_p = left_id_p->u.str.str_p;
+        char *id_str_p = left_id_p->u.id.str_p;
 
         id_err_line = left_id_p->current_line;
         id_err_col = left_id_p->current_col;
@@ -158,7 +157,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             /* return the right expr info */
             res_expr_info = right_expr_info;
@@ -173,7 +172,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -195,7 +194,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "/=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -218,7 +217,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "/=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -237,7 +236,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "/=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -246,7 +245,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -259,7 +258,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -281,7 +280,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "*=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -304,7 +303,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "*=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -323,7 +322,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "*=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -332,7 +331,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -345,7 +344,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -365,7 +364,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "%=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -384,7 +383,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "%=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -403,7 +402,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "%=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -412,7 +411,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -425,9 +424,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
-
-            char buff_s[100];
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -449,7 +446,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "+=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -472,7 +469,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "+=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -491,7 +488,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "+=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -500,7 +497,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -513,9 +510,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
-
-            char buff_s[100];
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -537,7 +532,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "-=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -560,7 +555,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "-=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -579,7 +574,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "-=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -588,7 +583,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -601,9 +596,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
-
-            char buff_s[100];
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -623,7 +616,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "<<=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -642,7 +635,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "<<=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -661,7 +654,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "<<=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -670,7 +663,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -683,9 +676,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
-
-            char buff_s[100];
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -705,7 +696,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, ">>=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -724,7 +715,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, ">>=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -743,7 +734,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, ">>=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -752,7 +743,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -765,9 +756,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
-
-            char buff_s[100];
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -787,7 +776,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, ">>>=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -806,7 +795,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, ">>>=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -825,7 +814,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, ">>>=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -834,7 +823,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -847,9 +836,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
-
-            char buff_s[100];
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -869,7 +856,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "&=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -888,7 +875,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "&=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -907,7 +894,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "&=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -916,7 +903,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -929,9 +916,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
-
-            char buff_s[100];
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -951,7 +936,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "^=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -970,7 +955,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "^=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -989,7 +974,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "^=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -998,7 +983,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -1011,7 +996,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
 
             right_expr_info = l2_eval_expr_assign(scope_p);
             left_symbol_p = l2_eval_get_symbol_node(scope_p, id_str_p);
-            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+            if (!left_symbol_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             switch (right_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_INTEGER:
@@ -1031,7 +1016,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "|=", "between native pointer and integer");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -1050,7 +1035,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "|=", "between native pointer and real");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -1069,7 +1054,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
                         //    l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_OPERATION, opr_err_line, opr_err_col, "|=", "between native pointer and bool");
 
                         default:
-                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, left_id_p->current_line, left_id_p->current_col);
+                            l2_parsing_error(L2_PARSING_ERROR_INCOMPATIBLE_SYMBOL_TYPE, id_err_line, id_err_col);
                     }
                     break;
 
@@ -1078,7 +1063,7 @@ l2_expr_info l2_eval_expr_assign(l2_scope *scope_p) {
             }
 
             if (!symbol_updated) /* if update symbol failed */
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
             return res_expr_info;
 
@@ -1163,9 +1148,15 @@ l2_expr_info l2_eval_expr_logic_or1(l2_scope *scope_p, l2_expr_info left_expr_in
     _if_type (L2_TOKEN_LOGIC_OR)
     {
         _get_current_token_p
-        right_expr_info = l2_eval_expr_logic_and(scope_p);
         _if (left_expr_info.val_type == L2_EXPR_VAL_TYPE_BOOL)
         {
+            /* the right expr is not evaluated if the left one is true */
+            if (left_expr_info.val.bool) {
+                l2_absorb_expr_logic_and();
+                return l2_eval_expr_logic_or1(scope_p, left_expr_info);
+            }
+
+            right_expr_info = l2_eval_expr_logic_and(scope_p);
             _if (right_expr_info.val_type == L2_EXPR_VAL_TYPE_BOOL)
             {
                 new_left_expr_info.val_type = L2_EXPR_VAL_TYPE_BOOL;
@@ -1209,8 +1200,14 @@ l2_expr_info l2_eval_expr_logic_and1(l2_scope *scope_p, l2_expr_info left_expr_i
     _if_type (L2_TOKEN_LOGIC_AND)
     {
         _get_current_token_p
-        right_expr_info = l2_eval_expr_bit_or(scope_p);
         _if (left_expr_info.val_type == L2_EXPR_VAL_TYPE_BOOL) {
+            /* the right expr is not evaluated if the left one is false */
+            if (!left_expr_info.val.bool) {
+                l2_absorb_expr_bit_or();
+                return l2_eval_expr_logic_and1(scope_p, left_expr_info);
+            }
+
+            right_expr_info = l2_eval_expr_bit_or(scope_p);
             _if (right_expr_info.val_type == L2_EXPR_VAL_TYPE_BOOL) {
                 new_left_expr_info.val_type = L2_EXPR_VAL_TYPE_BOOL;
                 new_left_expr_info.val.bool = (left_expr_info.val.bool && right_expr_info.val.bool);
@@ -2525,8 +2522,7 @@ l2_expr_info l2_eval_expr_single(l2_scope *scope_p) {
  * | , expr_assign real_param_list1
  * | nil
  * */
-void l2_parse_real_param_list1(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
-    _declr_current_token_p
+void l2_parse_real_param_list1(l2_scope *scope_p, l2_expr_info_vector *expr_info_vec_p) {
     _if_type (L2_TOKEN_COMMA)
     {
         int before_eval_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
@@ -2534,7 +2530,7 @@ void l2_parse_real_param_list1(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
 
         _if (expr_info.val_type != L2_EXPR_VAL_NOT_EXPR)
         {
-            l2_vector_append(expr_info_vec_p, &expr_info);
+            l2_expr_info_vector_append(expr_info_vec_p, expr_info);
             l2_parse_real_param_list1(scope_p, expr_info_vec_p);
 
         }
@@ -2551,15 +2547,13 @@ void l2_parse_real_param_list1(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
  * | nil
  *
  * */
-void l2_parse_real_param_list(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
-    _declr_current_token_p
-
+void l2_parse_real_param_list(l2_scope *scope_p, l2_expr_info_vector *expr_info_vec_p) {
     int before_eval_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
     l2_expr_info expr_info = l2_eval_expr_assign(scope_p);
 
     _if (expr_info.val_type != L2_EXPR_VAL_NOT_EXPR)
     {
-        l2_vector_append(expr_info_vec_p, &expr_info);
+        l2_expr_info_vector_append(expr_info_vec_p, expr_info);
         l2_parse_real_param_list1(scope_p, expr_info_vec_p);
 
     }
@@ -2575,7 +2569,7 @@ void l2_parse_real_param_list(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
  * */
 /* expr_info_vec_p: including the exprs of real parameters */
 /* symbol_pos: the current identifier count */
-void l2_parse_formal_param_list1(l2_scope *scope_p, l2_vector *expr_info_vec_p, int *symbol_pos_p) {
+void l2_parse_formal_param_list1(l2_scope *scope_p, l2_expr_info_vector *expr_info_vec_p, int *symbol_pos_p) {
     _declr_current_token_p
     _if_type (L2_TOKEN_COMMA)
     {
@@ -2583,11 +2577,11 @@ void l2_parse_formal_param_list1(l2_scope *scope_p, l2_vector *expr_info_vec_p,
         {
             _get_current_token_p
             /* if (id count < real params count) */
-            if ((*symbol_pos_p) < expr_info_vec_p->size) {
+            if ((*symbol_pos_p) < (int)expr_info_vec_p->size) {
 
                 l2_symbol symbol;
 
-                l2_expr_info real_expr_info = *(l2_expr_info *)l2_vector_at(expr_info_vec_p, (*symbol_pos_p));
+                l2_expr_info real_expr_info = *l2_expr_info_vector_at(expr_info_vec_p, (*symbol_pos_p));
 
                 switch (real_expr_info.val_type) {
                     case L2_EXPR_VAL_TYPE_BOOL:
@@ -2610,16 +2604,16 @@ void l2_parse_formal_param_list1(l2_scope *scope_p, l2_vector *expr_info_vec_p,
                         symbol.u.procedure = real_expr_info.val.procedure;
                         break;
 
-                    case L2_EXPR_VAL_NO_VAL:
+                    default: /* no value */
                         l2_parsing_error(L2_PARSING_ERROR_EXPR_RESULT_WITHOUT_VALUE, current_token_p->current_line, current_token_p->current_col);
                 }
 
-                symbol.symbol_name = current_token_p->u.str.str_p;
+                symbol.symbol_name = current_token_p->u.id.str_p;
 
-                boolean add_symbol_result = l2_symbol_table_add_symbol(&scope_p->symbol_table_p, symbol);
+                boolean add_symbol_result = l2_symbol_table_add_symbol(scope_p, symbol);
 
                 if (!add_symbol_result) {
-                    l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.str.str_p);
+                    l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.id.str_p);
                 }
 
                 (*symbol_pos_p) += 1;
@@ -2654,7 +2648,7 @@ void l2_parse_formal_param_list1(l2_scope *scope_p, l2_vector *expr_info_vec_p,
  * | nil
  *
  * */
-void l2_parse_formal_param_list(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
+void l2_parse_formal_param_list(l2_scope *scope_p, l2_expr_info_vector *expr_info_vec_p) {
     _declr_current_token_p
     _get_current_token_p
     int symbol_pos = 0;
@@ -2662,11 +2656,11 @@ void l2_parse_formal_param_list(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
     _if_type (L2_TOKEN_IDENTIFIER)
     {
         _get_current_token_p
-        if (symbol_pos < expr_info_vec_p->size) {
+        if (symbol_pos < (int)expr_info_vec_p->size) {
 
             l2_symbol symbol;
 
-            l2_expr_info real_expr_info = *(l2_expr_info *)l2_vector_at(expr_info_vec_p, symbol_pos);
+            l2_expr_info real_expr_info = *l2_expr_info_vector_at(expr_info_vec_p, symbol_pos);
 
             switch (real_expr_info.val_type) {
                 case L2_EXPR_VAL_TYPE_BOOL:
@@ -2689,16 +2683,16 @@ void l2_parse_formal_param_list(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
                     symbol.u.procedure = real_expr_info.val.procedure;
                     break;
 
-                case L2_EXPR_VAL_NO_VAL:
+                default: /* no value */
                     l2_parsing_error(L2_PARSING_ERROR_EXPR_RESULT_WITHOUT_VALUE, current_token_p->current_line, current_token_p->current_col);
             }
 
-            symbol.symbol_name = current_token_p->u.str.str_p;
+            symbol.symbol_name = current_token_p->u.id.str_p;
 
-            boolean add_symbol_result = l2_symbol_table_add_symbol(&scope_p->symbol_table_p, symbol);
+            boolean add_symbol_result = l2_symbol_table_add_symbol(scope_p, symbol);
 
             if (!add_symbol_result) {
-                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.str.str_p);
+                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.id.str_p);
             }
 
             symbol_pos += 1;
@@ -2725,12 +2719,157 @@ void l2_parse_formal_param_list(l2_scope *scope_p, l2_vector *expr_info_vec_p) {
 
     } _end
 
-    if (symbol_pos < expr_info_vec_p->size) {
+    if (symbol_pos < (int)expr_info_vec_p->size) {
         l2_parsing_error(L2_PARSING_ERROR_TOO_MANY_PARAMETERS, current_token_p->current_line, current_token_p->current_col);
     }
 }
 
 
+/* call the procedure with the values of real parameters, the vector is destroyed when the procedure returns,
+ * the callee of tail call inside it runs in place of it, with the same frame
+ * */
+l2_expr_info l2_eval_call_procedure(l2_procedure procedure, l2_expr_info_vector expr_info_vec, l2_token *call_token_p) {
+    l2_expr_info res_expr_info;
+    l2_call_frame call_frame;
+    l2_scope *procedure_scope_p;
+    l2_stmt_interrupt irt;
+
+    /* create new sub scope */
+    procedure_scope_p = l2_scope_create_procedure_scope(procedure.upper_scope_p, L2_SCOPE_CREATE_SUB_SCOPE);
+
+    /* put all of call procedure informations into a single call_frame */
+    call_frame.param_list.expr_info_vec = expr_info_vec;
+    call_frame.ret_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
+    call_frame.ret_scope_p = L2_NULL_PTR;
+    call_frame.procedure_scope_p = procedure_scope_p;
+
+    l2_call_stack_push_frame(g_parser_p->call_stack_p, call_frame, call_token_p->current_line, call_token_p->current_col);
+
+    while (1) {
+        /* perform procedure call, take parser into a new token stream position */
+        l2_token_stream_set_pos(g_parser_p->token_stream_p, procedure.entry_pos);
+
+        _if_type (L2_TOKEN_LP) /* ( */
+        {
+            l2_parse_formal_param_list(procedure_scope_p, &expr_info_vec);
+
+            _if_type (L2_TOKEN_RP)
+            {
+                /* absorb ')' */
+            } _throw_missing_rp
+
+            _if_type (L2_TOKEN_LBRACE) /* { */
+            {
+                /* braces flag + 1 */
+                g_parser_p->braces_flag += 1;
+
+                irt = l2_parse_stmts(procedure_scope_p);
+
+                switch (irt.type) {
+                    case L2_STMT_INTERRUPT_CONTINUE:
+                        l2_parsing_error(L2_PARSING_ERROR_INVALID_CONTINUE_IN_CURRENT_CONTEXT, irt.line_of_irt_stmt, irt.col_of_irt_stmt);
+
+                    case L2_STMT_INTERRUPT_BREAK:
+                        l2_parsing_error(L2_PARSING_ERROR_INVALID_BREAK_IN_CURRENT_CONTEXT, irt.line_of_irt_stmt, irt.col_of_irt_stmt);
+
+                    case L2_STMT_INTERRUPT_RETURN_WITH_VAL:
+                        /* the copy with light transfer */
+                        memcpy(&res_expr_info, &irt.u.ret_expr_info, sizeof(res_expr_info));
+                        break;
+
+                    case L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL:
+                        /* no return value */
+                        res_expr_info.val_type = L2_EXPR_VAL_NO_VAL;
+                        break;
+
+                    case L2_STMT_INTERRUPT_TAIL_CALL:
+                        /* the value is returned by the callee */
+                        break;
+
+                    case L2_STMT_NO_INTERRUPT:
+                        /* no interrupt means no return stmt */
+                        res_expr_info.val_type = L2_EXPR_VAL_NO_VAL;
+                        break;
+
+                    default: /* NOT STMT */
+                        res_expr_info.val_type = L2_EXPR_VAL_NOT_EXPR;
+                }
+
+                _if_type (L2_TOKEN_RBRACE)
+                {
+                    /* absorb '}' */
+                } _throw_missing_rbrace
+
+            } _throw_unexpected_token
+
+        } _throw_unexpected_token
+
+        l2_scope_escape_scope(procedure_scope_p); /* escape from procedure scope */
+        l2_expr_info_vector_destroy(&expr_info_vec);
+
+        if (irt.type != L2_STMT_INTERRUPT_TAIL_CALL) break;
+
+        /* the callee of tail call runs in place of current procedure */
+        procedure = irt.u.tail_call.procedure;
+        expr_info_vec = irt.u.tail_call.expr_info_vec;
+        procedure_scope_p = l2_scope_create_procedure_scope(procedure.upper_scope_p, L2_SCOPE_CREATE_SUB_SCOPE);
+        l2_call_stack_reuse_frame(g_parser_p->call_stack_p, procedure_scope_p);
+    }
+
+    /* procedure execution complete, restore call frame */
+    call_frame = l2_call_stack_pop_frame(g_parser_p->call_stack_p);
+    l2_token_stream_set_pos(g_parser_p->token_stream_p, call_frame.ret_pos);
+
+    return res_expr_info;
+}
+
+/* return id ( real_param_list ) ;
+ * the real parameters are evaluated in current procedure, and the callee is called after current procedure returns
+ * if its frame could be reused, otherwise it is called as usual,
+ * returns false if the returned expr is not a single call, and nothing is parsed
+ * */
+boolean l2_eval_tail_call(l2_scope *scope_p, l2_stmt_interrupt *irt_p) {
+    l2_token_stream *token_stream_p = g_parser_p->token_stream_p;
+    l2_token call_token;
+    l2_symbol_node *symbol_node_p;
+    l2_stmt_tail_call tail_call;
+
+    if (l2_token_stream_peek_type(token_stream_p, 1) != L2_TOKEN_IDENTIFIER
+        || l2_token_stream_peek_type(token_stream_p, 2) != L2_TOKEN_LP
+        || l2_token_stream_peek_type_after_bracket(token_stream_p, 2) != L2_TOKEN_SEMICOLON)
+        return L2_FALSE;
+
+    /* the errors of calling are reported by the usual call */
+    call_token = *l2_token_stream_peek_token(token_stream_p, 1);
+    symbol_node_p = l2_eval_get_symbol_node(scope_p, call_token.u.id.str_p);
+    if (!symbol_node_p || symbol_node_p->symbol.type != L2_SYMBOL_TYPE_PROCEDURE)
+        return L2_FALSE;
+
+    l2_token_stream_match(token_stream_p, L2_TOKEN_IDENTIFIER);
+    l2_token_stream_match(token_stream_p, L2_TOKEN_LP);
+
+    tail_call.procedure = symbol_node_p->symbol.u.procedure;
+    l2_expr_info_vector_create(&tail_call.expr_info_vec);
+    l2_parse_real_param_list(scope_p, &tail_call.expr_info_vec);
+
+    _if_type (L2_TOKEN_RP)
+    {
+        /* absorb ')' */
+    } _throw_missing_rp
+
+    if (l2_call_stack_could_reuse_frame(g_parser_p->call_stack_p, scope_p, &tail_call.procedure,
+                                        tail_call.expr_info_vec.vector_p, tail_call.expr_info_vec.size)) {
+        irt_p->type = L2_STMT_INTERRUPT_TAIL_CALL;
+        irt_p->u.tail_call = tail_call;
+
+    } else {
+        irt_p->type = L2_STMT_INTERRUPT_RETURN_WITH_VAL;
+        irt_p->u.ret_expr_info = l2_eval_call_procedure(tail_call.procedure, tail_call.expr_info_vec, &call_token);
+    }
+
+    return L2_TRUE;
+}
+
 /* expr_atom ->
  * | ( expr )
  * | id
@@ -2765,11 +2904,11 @@ l2_expr_info l2_eval_expr_atom(l2_scope *scope_p) {
         {
             /* TODO handle procedure calling */
             //symbol_node_p->symbol.u.procedure
-            symbol_node_p = l2_eval_get_symbol_node(scope_p, current_token_p->u.str.str_p);
-            if (!symbol_node_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.str.str_p);
+            symbol_node_p = l2_eval_get_symbol_node(scope_p, current_token_p->u.id.str_p);
+            if (!symbol_node_p) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.id.str_p);
 
-            l2_vector expr_info_vec;
-            l2_vector_create(&expr_info_vec, sizeof(l2_expr_info));
+            l2_expr_info_vector expr_info_vec;
+            l2_expr_info_vector_create(&expr_info_vec);
             l2_parse_real_param_list(scope_p, &expr_info_vec);
 
             _if_type (L2_TOKEN_RP)
@@ -2780,94 +2919,22 @@ l2_expr_info l2_eval_expr_atom(l2_scope *scope_p) {
 
             /* judge the symbol type ( procedure ) */
             if (symbol_node_p->symbol.type == L2_SYMBOL_TYPE_PROCEDURE) {
-
-                /* put all of call procedure informations into a single call_frame */
-                l2_call_frame call_frame;
-                call_frame.param_list.expr_info_vec = expr_info_vec;
-                call_frame.ret_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
-
-                l2_call_stack_push_frame(g_parser_p->call_stack_p, call_frame);
-
-                /* perform procedure call, take parser into a new token stream position */
-                l2_token_stream_set_pos(g_parser_p->token_stream_p, symbol_node_p->symbol.u.procedure.entry_pos);
-
-                /* create new sub scope */
-
-                l2_scope *procedure_scope_p = l2_scope_create_procedure_scope(symbol_node_p->symbol.u.procedure.upper_scope_p, L2_SCOPE_CREATE_SUB_SCOPE);
-
-                /* TODO enter into procedure */
-                _if_type (L2_TOKEN_LP) /* ( */
-                {
-                    l2_parse_formal_param_list(procedure_scope_p, &expr_info_vec);
-
-                    _if_type (L2_TOKEN_RP)
-                    {
-                        /* absorb ')' */
-                    } _throw_missing_rp
-
-                    _if_type (L2_TOKEN_LBRACE) /* { */
-                    {
-                        /* braces flag + 1 */
-                        g_parser_p->braces_flag += 1;
-
-                        /* TODO the function maybe return a interrupt */
-                        l2_stmt_interrupt irt = l2_parse_stmts(procedure_scope_p);
-
-                        switch (irt.type) {
-                            case L2_STMT_INTERRUPT_CONTINUE:
-                                l2_parsing_error(L2_PARSING_ERROR_INVALID_CONTINUE_IN_CURRENT_CONTEXT, irt.line_of_irt_stmt, irt.col_of_irt_stmt);
-
-                            case L2_STMT_INTERRUPT_BREAK:
-                                l2_parsing_error(L2_PARSING_ERROR_INVALID_BREAK_IN_CURRENT_CONTEXT, irt.line_of_irt_stmt, irt.col_of_irt_stmt);
-
-                            case L2_STMT_INTERRUPT_RETURN_WITH_VAL:
-                                /* the copy with light transfer */
-                                memcpy(&res_expr_info, &irt.u.ret_expr_info, sizeof(res_expr_info));
-                                break;
-
-                            case L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL:
-                                /* no return value */
-                                res_expr_info.val_type = L2_EXPR_VAL_NO_VAL;
-                                break;
-
-                            case L2_STMT_NO_INTERRUPT:
-                                /* no interrupt means no return stmt */
-                                res_expr_info.val_type = L2_EXPR_VAL_NO_VAL;
-                                break;
-
-                            default: /* NOT STMT */
-                                res_expr_info.val_type = L2_EXPR_VAL_NOT_EXPR;
-                        }
-
-                        _if_type (L2_TOKEN_RBRACE)
-                        {
-                            /* absorb '}' */
-                        } _throw_missing_rbrace
-
-                    } _throw_unexpected_token
-
-                } _throw_unexpected_token
-
-                /* procedure execution complete, restore call frame*/
-                l2_scope_escape_scope(procedure_scope_p); /* escape from procedure scope */
-                call_frame = l2_call_stack_pop_frame(g_parser_p->call_stack_p);
-                l2_token_stream_set_pos(g_parser_p->token_stream_p, call_frame.ret_pos);
-                l2_vector_destroy(&expr_info_vec);
+                res_expr_info = l2_eval_call_procedure(symbol_node_p->symbol.u.procedure, expr_info_vec, current_token_p);
 
             } else { /* symbol is not procedure, it will not call the procedure */
-                l2_vector_destroy(&expr_info_vec);
-                l2_parsing_error(L2_PARSING_ERROR_SYMBOL_IS_NOT_PROCEDURE, current_token_p->current_line, current_token_p->current_col, current_token_p->u.str.str_p);
+                l2_expr_info_vector_destroy(&expr_info_vec);
+                l2_parsing_error(L2_PARSING_ERROR_SYMBOL_IS_NOT_PROCEDURE, current_token_p->current_line, current_token_p->current_col, current_token_p->u.id.str_p);
             }
 
             return res_expr_info;
         }
         _else /* pure id */
         {
-            char *id_str_p = current_token_p->u.str.str_p;
+            char *id_str_p = current_token_p->u.id.str_p;
             symbol_node_p = l2_eval_get_symbol_node(scope_p, id_str_p);
             if (!symbol_node_p)
                 l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, current_token_p->current_line,
-                                 current_token_p->current_col, current_token_p->u.str.str_p);
+                                 current_token_p->current_col, current_token_p->u.id.str_p);
 
             switch (symbol_node_p->symbol.type) { /* package symbol into expr node */
                 case L2_SYMBOL_TYPE_INTEGER:
@@ -3016,7 +3083,6 @@ boolean l2_absorb_expr_assign() {
  * | expr_logic_or
  * */
 boolean l2_absorb_expr_condition() {
-    _declr_current_token_p
     if (l2_absorb_expr_logic_or()) {
         _if_type(L2_TOKEN_QM)
         {
@@ -3416,7 +3482,6 @@ boolean l2_absorb_expr_single() {
  * | nil
  * */
 void l2_absorb_real_param_list1() {
-    _declr_current_token_p
     _if_type (L2_TOKEN_COMMA)
     {
         int before_eval_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
@@ -3439,8 +3504,6 @@ void l2_absorb_real_param_list1() {
  *
  * */
 void l2_absorb_real_param_list() {
-    _declr_current_token_p
-
     int before_eval_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
 
     _if (l2_absorb_expr_assign())
@@ -2,8 +2,8 @@
 #define _L2_EVAL_H_
 
 #include "l2_token_stream.h"
-#include "l2_parse.h"
 #include "l2_symbol_table.h"
+#include "../l2_tpl/l2_stack.h"
 
 typedef enum _l2_expr_val_type {
     L2_EXPR_VAL_NOT_EXPR, /* not expr */
@@ -26,6 +26,9 @@ typedef struct _l2_expr_info {
     }val;
 }l2_expr_info;
 
+L2_VECTOR_DEFINE(l2_expr_info)
+L2_STACK_DEFINE(l2_expr_info)
+
 l2_expr_info l2_eval_expr(l2_scope *scope_p);
 l2_expr_info l2_eval_expr_comma(l2_scope *scope_p);
 l2_expr_info l2_eval_expr_assign(l2_scope *scope_p);
@@ -60,11 +63,12 @@ boolean l2_absorb_expr_mul_div_mod();
 boolean l2_absorb_expr_single();
 boolean l2_absorb_expr_atom();
 
-void l2_parse_real_param_list(l2_scope *scope_p, l2_vector *symbol_vec_p);
-void l2_parse_real_param_list1(l2_scope *scope_p, l2_vector *symbol_vec_p);
+void l2_parse_real_param_list(l2_scope *scope_p, l2_expr_info_vector *expr_info_vec_p);
+void l2_parse_real_param_list1(l2_scope *scope_p, l2_expr_info_vector *expr_info_vec_p);
 
+l2_symbol_node *l2_eval_get_symbol_node(l2_scope *scope_p, char *symbol_name);
 boolean l2_eval_update_symbol_bool(l2_scope *scope_p, char *symbol_name, boolean bool);
-boolean l2_eval_update_symbol_integer(l2_scope *scope_p, char *symbol_name, int integer);
+boolean l2_eval_update_symbol_integer(l2_scope *scope_p, char *symbol_name, int64_t integer);
 boolean l2_eval_update_symbol_real(l2_scope *scope_p, char *symbol_name, double real);
 
 
@@ -0,0 +1,91 @@
+#include "stddef.h"
+#include "string.h"
+#include "l2_intern.h"
+#include "l2_parse.h"
+#include "../l2_drv/l2_assert.h"
+
+#define L2_INTERN_POOL_INIT_MAX_COUNT 64
+
+extern l2_parser *g_parser_p;
+
+/* FNV-1a */
+unsigned int l2_intern_hash(const char *str_p, int len) {
+    unsigned int hash = 2166136261u;
+    int i;
+    for (i = 0; i < len; i++) {
+        hash ^= (unsigned char)str_p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* the strs and buckets are allocated in a single block */
+void l2_intern_pool_alloc(l2_intern_pool *pool_p, int max_count) {
+    pool_p->max_count = max_count;
+    pool_p->strs_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, max_count * 3 * sizeof(l2_intern_str *));
+    pool_p->buckets_p = pool_p->strs_p + max_count;
+}
+
+/* the buckets are at most half full, so that the probing always stops at an empty bucket */
+void l2_intern_pool_link_bucket(l2_intern_pool *pool_p, l2_intern_str *intern_str_p) {
+    unsigned int mask = pool_p->max_count * 2 - 1, i;
+
+    for (i = intern_str_p->hash & mask; pool_p->buckets_p[i]; i = (i + 1) & mask);
+    pool_p->buckets_p[i] = intern_str_p;
+}
+
+l2_intern_pool *l2_intern_pool_create() {
+    l2_intern_pool *pool_p;
+    pool_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_intern_pool));
+    l2_intern_pool_alloc(pool_p, L2_INTERN_POOL_INIT_MAX_COUNT);
+    return pool_p;
+}
+
+void l2_intern_pool_destroy(l2_intern_pool *pool_p) {
+    int i;
+    for (i = 0; i < pool_p->count; i++)
+        l2_storage_mem_delete(g_parser_p->storage_p, pool_p->strs_p[i]);
+    l2_storage_mem_delete(g_parser_p->storage_p, pool_p->strs_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, pool_p);
+}
+
+/* returns the interned copy of str, which is kept until the pool is destroyed */
+char *l2_intern_pool_intern(l2_intern_pool *pool_p, const char *str_p, int len) {
+    unsigned int hash = l2_intern_hash(str_p, len), mask = pool_p->max_count * 2 - 1, i;
+    l2_intern_str *intern_str_p, **old_strs_p;
+
+    for (i = hash & mask; (intern_str_p = pool_p->buckets_p[i]); i = (i + 1) & mask) {
+        if (intern_str_p->hash == hash && strncmp(intern_str_p->str, str_p, len) == 0 && intern_str_p->str[len] == L2_STRING_END_MASK)
+            return intern_str_p->str;
+    }
+
+    if (pool_p->count >= pool_p->max_count) {
+        old_strs_p = pool_p->strs_p;
+        l2_intern_pool_alloc(pool_p, pool_p->max_count * 2);
+        for (i = 0; i < (unsigned int)pool_p->count; i++) {
+            pool_p->strs_p[i] = old_strs_p[i];
+            l2_intern_pool_link_bucket(pool_p, old_strs_p[i]);
+        }
+        l2_storage_mem_delete(g_parser_p->storage_p, old_strs_p);
+    }
+
+    intern_str_p = l2_storage_mem_new(g_parser_p->storage_p, offsetof(l2_intern_str, str) + len + 1);
+    intern_str_p->atom = pool_p->count;
+    intern_str_p->hash = hash;
+    memcpy(intern_str_p->str, str_p, len);
+    intern_str_p->str[len] = L2_STRING_END_MASK;
+
+    pool_p->strs_p[pool_p->count++] = intern_str_p;
+    l2_intern_pool_link_bucket(pool_p, intern_str_p);
+    return intern_str_p->str;
+}
+
+char *l2_intern_pool_get_str(l2_intern_pool *pool_p, l2_atom atom) {
+    l2_assert(atom >= 0 && atom < pool_p->count, L2_INTERNAL_ERROR_OUT_OF_RANGE);
+    return pool_p->strs_p[atom]->str;
+}
+
+/* the str must be returned by l2_intern_pool_intern */
+l2_atom l2_intern_atom(const char *interned_str_p) {
+    return ((l2_intern_str *)(interned_str_p - offsetof(l2_intern_str, str)))->atom;
+}
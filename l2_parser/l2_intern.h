@@ -0,0 +1,32 @@
+#ifndef _L2_INTERN_H_
+#define _L2_INTERN_H_
+
+#include "../l2_tpl/l2_common_type.h"
+
+typedef int l2_atom;
+
+/* each distinct identifier is stored once in the intern pool,
+ * the atom is the order of the string in pool, which is kept before its characters,
+ * so two interned strings are the same identifier if and only if they are the same pointer
+ * */
+typedef struct _l2_intern_str {
+    l2_atom atom;
+    unsigned int hash;
+    char str[1];
+}l2_intern_str;
+
+typedef struct _l2_intern_pool {
+    int count;
+    int max_count; /* the capacity of strs, which is power of 2, and the count of buckets is twice of it */
+    l2_intern_str **strs_p; /* indexed by atom */
+    l2_intern_str **buckets_p;
+}l2_intern_pool;
+
+l2_intern_pool *l2_intern_pool_create();
+void l2_intern_pool_destroy(l2_intern_pool *pool_p);
+
+char *l2_intern_pool_intern(l2_intern_pool *pool_p, const char *str_p, int len);
+char *l2_intern_pool_get_str(l2_intern_pool *pool_p, l2_atom atom);
+l2_atom l2_intern_atom(const char *interned_str_p);
+
+#endif
@@ -1,6 +1,7 @@
 #include "memory.h"
 #include "stdlib.h"
 #include "string.h"
+#include "string.h"
 #include "l2_parse.h"
 #include "l2_token_stream.h"
 #include "l2_symbol_table.h"
@@ -8,11 +9,21 @@
 #include "../l2_drv/l2_assert.h"
 #include "l2_eval.h"
 #include "l2_scope.h"
+#include "l2_ast_eval.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 l2_parser *g_parser_p;
 
 void l2_parse_finalize() {
+    l2_vm_destroy(g_parser_p->vm_p);
+    l2_ast_destroy(g_parser_p->ast_p);
     l2_token_stream_destroy(g_parser_p->token_stream_p);
+    l2_intern_pool_destroy(g_parser_p->intern_pool_p);
     l2_call_stack_destroy(g_parser_p->call_stack_p);
     l2_scope_destroy(g_parser_p->global_scope_p);
     l2_gc_destroy(g_parser_p->gc_list_p);
@@ -20,456 +31,79 @@ void l2_parse_finalize() {
     free(g_parser_p);
 }
 
-void l2_parse_initialize(FILE *fp) {
+/* the source path is null if the source is read from stdin or the token cache is disabled */
+void l2_parse_initialize(FILE *fp, const char *source_path_p, l2_engine_type engine_type, int max_call_depth) {
     g_parser_p = malloc(sizeof(l2_parser));
-    g_parser_p->braces_flag = 0;
-    g_parser_p->storage_p = l2_storage_create();
-    g_parser_p->gc_list_p = l2_gc_create();
-    g_parser_p->global_scope_p = l2_scope_create();
-    g_parser_p->call_stack_p = l2_call_stack_create();
-    g_parser_p->token_stream_p = l2_token_stream_create(fp);
-}
-
-boolean l2_parse_probe_next_token_by_type_and_str(l2_token_type type, char *str) {
-    l2_token *t = l2_token_stream_next_token(g_parser_p->token_stream_p);
-    l2_token_stream_rollback(g_parser_p->token_stream_p);
-    return t->type == type && l2_string_equal_c(&t->u.str, str);
-}
-
-boolean l2_parse_probe_next_token_by_type(l2_token_type type) {
-    l2_token *t = l2_token_stream_next_token(g_parser_p->token_stream_p);
-    l2_token_stream_rollback(g_parser_p->token_stream_p);
-    return t->type == type;
-}
-
-void l2_parse() {
-    _repl_head
-    l2_parse_stmts(g_parser_p->global_scope_p);
-}
-
-void l2_absorb_stmt_var_def_list1();
-boolean l2_absorb_stmt_elif();
-void l2_absorb_formal_param_list();
-boolean l2_absorb_stmts();
-
-
-/* stmt ->
- * | { stmts }
- * | procedure id ( formal_param_list ) { stmts }
- * | while ( expr ) { stmts }
- * | do { stmts } while ( expr ) ;
- * | for ( expr ; expr ; expr ) { stmts }
- * | for ( var id = expr stmt_var_def_list1 ; expr ; expr ) { stmts }
- * | for ( var id stmt_var_def_list1 ; expr ; expr ) { stmts }
- * | break ;
- * | continue ;
- * | return ;
- * | return expr ;
- * | if ( expr ) { stmts } stmt_elif
- * | var id stmt_var_def_list1 ;
- * | var id = expr stmt_var_def_list1 ;
- * | ;
- * | expr ;
- * | eval expr;
- * |
- * */
-boolean l2_absorb_stmt() {
-    _declr_current_token_p
-
-    _if_keyword (L2_KW_BREAK) /* "break" */
-    {
-        _get_current_token_p
-        _if_type (L2_TOKEN_SEMICOLON)
-        {
-            /* absorb ';' */
-        } _throw_missing_semicolon
-    }
-    _elif_keyword (L2_KW_CONTINUE) /* "continue" */
-    {
-        _get_current_token_p
-        _if_type (L2_TOKEN_SEMICOLON)
-        {
-            /* absorb ';' */
-        } _throw_missing_semicolon
-    }
-    _elif_keyword (L2_KW_RETURN) /* "return" */
-    {
-        _get_current_token_p
-        _if_type (L2_TOKEN_SEMICOLON)
-        {
-            /* absorb ';' */
-        }
-        _else
-        {
-            l2_absorb_expr(); /* absorb return expr */
-
-            _if_type (L2_TOKEN_SEMICOLON)
-            {
-                /* absorb ';' */
-            } _throw_missing_semicolon
-        }
-    }
-    _elif_keyword (L2_KW_PROCEDURE) /* "procedure" */ /* the definition of procedure */
-    {
-        _if_type (L2_TOKEN_IDENTIFIER) /* id */
-        {
-
-            _if_type (L2_TOKEN_LP) /* ( */
-            {
-                l2_absorb_formal_param_list();
-
-                _if_type (L2_TOKEN_RP)
-                {
-                    /* absorb ')' */
-                } _throw_missing_rp
-
-                _if_type (L2_TOKEN_LBRACE) /* { */
-                {
-                    /* braces flag + 1 */
-                    g_parser_p->braces_flag += 1;
-
-                    boolean stmts_flag = l2_absorb_stmts(); /* absorb stmts */
-
-                    _if_type (L2_TOKEN_RBRACE)
-                    {
-                        /* absorb '}' */
-                    } _throw_missing_rbrace
-
-                    return stmts_flag;
-
-                } _throw_unexpected_token
-
-            } _throw_unexpected_token
-
-        } _throw_unexpected_token
-    }
-    _elif_keyword (L2_KW_FOR) /* "for" */ /* for-loop */
-    {
-        _if_type (L2_TOKEN_LP) /* ( */
-        {
-            /* handle the first expr ( allow to using definition stmt for variable )*/
-            _if_keyword (L2_KW_VAR)
-            {
-                _if_type (L2_TOKEN_IDENTIFIER) /* id */
-                {
-                    _get_current_token_p
-
-                    _if_type (L2_TOKEN_ASSIGN) /* = */
-                    {
-                        l2_absorb_expr_assign(); /* absorb expr */
-
-                        /* absorb last part of definition list in recursion */
-                        l2_absorb_stmt_var_def_list1();
-
-                        _if_type (L2_TOKEN_SEMICOLON)
-                        {
-                            /* absorb ';' */
-                        } _throw_missing_semicolon
-
-                    }
-                    _elif_type (L2_TOKEN_SEMICOLON)
-                    {
-                        /* absorb ';' without initializing the variable */
-                    } _throw_unexpected_token
-
-                } _throw_unexpected_token
-            }
-            _elif_type (L2_TOKEN_SEMICOLON)
-            {
-                /* this means there is an empty expr in for-loop */
-                /* also absorb ';' */
-            }
-            _else
-            {
-                l2_absorb_expr();
-                _if_type (L2_TOKEN_SEMICOLON)
-                {
-                    /* absorb ';' */
-                } _throw_missing_semicolon
-            }
-
-            _if_type (L2_TOKEN_SEMICOLON)
-            {
-                /* this means there is an empty expr in for-loop,
-                 * and the second expr will have a bool-value with true if it is empty  */
-                /* also absorb ';' */
-            }
-            _else
-            {
-                l2_absorb_expr();
-                _if_type (L2_TOKEN_SEMICOLON)
-                {
-                    /* absorb ';' */
-                } _throw_missing_semicolon
-            }
-
-            /* handle the third expr ( absorb it ) */
-            _if_type(L2_TOKEN_RP)
-            {
-                /* this means there is an empty expr */
-            }
-            _else
-            {
-                /* just absorb the third expr */
-                l2_absorb_expr();
-                _if_type (L2_TOKEN_RP)
-                {
-                    /* absorb ')' */
-                } _throw_missing_rp
-            }
-
-        } _throw_unexpected_token
-
-        /* absorb the for stmt loop structure */
-        _if_type (L2_TOKEN_LBRACE) /* { */
-        {
-            /* braces flag + 1 */
-            g_parser_p->braces_flag += 1;
-
-            boolean stmts_flag = l2_absorb_stmts(); /* parse stmts, may parse break or continue*/
-
-            _if_type (L2_TOKEN_RBRACE) /* } */
-            {
-                /* absorb '}' */
-            }_throw_missing_rbrace
-
-            return stmts_flag;
-
-        } _throw_unexpected_token
-
-    }
-    _elif_keyword (L2_KW_DO) /* "do" */ /* do...while-loop */
-    {
-        _if_type (L2_TOKEN_LBRACE) /* { */
-        {
-            /* braces flag + 1 */
-            g_parser_p->braces_flag += 1;
-
-            boolean stmts_flag = l2_absorb_stmts(); /* absorb stmts */
-
-            _if_type (L2_TOKEN_RBRACE) /* } */
-            {
-                /* absorb '}' */
-            } _throw_missing_rbrace
-
-            return stmts_flag;
-
-        } _throw_unexpected_token
-
-        _if_keyword (L2_KW_WHILE) /* "while" */
-        {
-            _get_current_token_p
-
-            _if_type (L2_TOKEN_LP) /* ( */
-            {
-                l2_absorb_expr(); /* absorb expr */
-            } _throw_unexpected_token
-
-            _if_type (L2_TOKEN_RP) /* ) */
-            {
-                /* absorb ')' */
-            } _throw_missing_rp
-
-            _if_type (L2_TOKEN_SEMICOLON) /* ; */
-            {
-                /* absorb ';' */
-            } _throw_missing_semicolon
-
-        } _throw_unexpected_token
-
-    }
-    _elif_keyword (L2_KW_WHILE) /* "while" */ /* while-loop */
-    {
-        _if_type (L2_TOKEN_LP) /* ( */
-        {
-            l2_absorb_expr(); /* absorb expr */
-
-            _if_type (L2_TOKEN_RP)
-            {
-                /* absorb ')' */
-            } _throw_missing_rp
-
-
-            _if_type (L2_TOKEN_LBRACE) /* { */
-            {
-                /* braces flag + 1 */
-                g_parser_p->braces_flag += 1;
-
-                boolean stmts_flag = l2_absorb_stmts(); /* absorb stmts */
-
-                _if_type (L2_TOKEN_RBRACE)
-                {
-                    /* absorb '}' */
-                } _throw_missing_rbrace
-
-                return stmts_flag;
-
-            } _throw_unexpected_token
-
-        } _throw_unexpected_token
-
-    }
-    _elif_type (L2_TOKEN_LBRACE) /* { */
-    {
-        /* braces flag + 1 */
-        g_parser_p->braces_flag += 1;
-
-        boolean stmts_flag = l2_absorb_stmts(); /* absorb stmts */
-
-        _if_type (L2_TOKEN_RBRACE) /* } */
-        {
-            /* absorb '}' */
-        } _throw_missing_rbrace
-
-        return stmts_flag;
-
-    }
-    _elif_keyword (L2_KW_IF) /* "if" */
-    {
-        _get_current_token_p
-
-        _if_type (L2_TOKEN_LP) /* ( */
-        {
-            l2_absorb_expr(); /* absorb expr */
-
-            _if_type (L2_TOKEN_RP)
-            {
-                /* absorb ')' */
-            } _throw_missing_rp
-
-            _if_type (L2_TOKEN_LBRACE) /* { */
-            {
-                /* braces flag + 1 */
-                g_parser_p->braces_flag += 1;
-
-                boolean stmts_flag = l2_absorb_stmts(); /* absorb stmts */
-
-                _if_type (L2_TOKEN_RBRACE) /* } */
-                {
-
-                } _throw_missing_rbrace
-
-                if (stmts_flag) {
-                    return l2_absorb_stmt_elif();
-                } else {
-                    return L2_FALSE;
-                }
-
-            } _throw_unexpected_token
-
-        } _throw_unexpected_token
-
-    }
-    _elif_type (L2_TOKEN_SEMICOLON)
-    {
-        /* empty stmt which has only single ; */
-    }
-    _elif_keyword (L2_KW_VAR) /* "var" */
-    {
-        _if_type (L2_TOKEN_IDENTIFIER) /* id */
-        {
-            _if_type (L2_TOKEN_ASSIGN) /* = */
-            {
-                l2_absorb_expr_assign(); /* expr_assign */
-            }
-            _else /* without initialization */
-            {
-
-            }
-
-            /* absorb last part of definition list in recursion */
-            l2_absorb_stmt_var_def_list1();
-
-            _if_type (L2_TOKEN_SEMICOLON)
-            {
-                /* absorb ';' */
-            } _throw_missing_semicolon
-
-        } _throw_unexpected_token
-
-    }
-    _elif_keyword(L2_KW_EVAL)
-    {
-        l2_absorb_expr(); /* absorb expr */
-
-        _if_type (L2_TOKEN_SEMICOLON)
-        {
-            /* absorb ';' */
-        } _throw_missing_semicolon
-    }
-    _else
-    {
-        if (!l2_absorb_expr()) { /* absorb expr */
-            /* braces flag - 1 */
-            g_parser_p->braces_flag -= 1;
-
-            _if (g_parser_p->braces_flag >= 0) {
-
-            } _throw_unexpected_token
-
-            return L2_FALSE;
-
-        } else {
-            /* if it's a expr, after eval_expr() then absorb ';' */
-            _if_type (L2_TOKEN_SEMICOLON)
-            {
-                /* absorb ';' */
-            } _throw_missing_semicolon
-        }
+    g_parser_p->engine_type = engine_type;
+    g_parser_p->braces_flag = 0;
+    g_parser_p->is_repl = fp == stdin && isatty(fileno(stdin));
 
-    }
+    /* the output is flushed when the buffer is full, instead of after each stmt */
+    if (fp == stdin && !g_parser_p->is_repl)
+        setvbuf(stdout, L2_NULL_PTR, _IOFBF, L2_PARSE_STDOUT_BUFF_SIZE);
 
-    return L2_TRUE;
+    g_parser_p->storage_p = l2_storage_create();
+    g_parser_p->gc_list_p = l2_gc_create();
+    g_parser_p->global_scope_p = l2_scope_create();
+    g_parser_p->call_stack_p = l2_call_stack_create(max_call_depth);
+    g_parser_p->intern_pool_p = l2_intern_pool_create();
+    g_parser_p->token_stream_p = l2_token_stream_create(fp, source_path_p);
+    g_parser_p->ast_p = l2_ast_create();
+    g_parser_p->vm_p = l2_vm_create();
 }
 
-/* stmts ->
- * | stmt stmts
- * | eof
- *
- * */
-boolean l2_absorb_stmts() {
-    _if_type(L2_TOKEN_TERMINATOR)
-    {
-        return L2_TRUE;
-    }
-    _else
-    {
-        if (!l2_absorb_stmt()) {
-            return L2_TRUE;
-        }
+boolean l2_parse_probe_next_token_by_type(l2_token_type type) {
+    return l2_token_stream_peek_type(g_parser_p->token_stream_p, 1) == type;
+}
 
-        return l2_absorb_stmts();
+void l2_parse() {
+    _repl_head
+    switch (g_parser_p->engine_type) {
+        case L2_ENGINE_TYPE_AST:
+            l2_ast_eval_program();
+            break;
+
+        case L2_ENGINE_TYPE_VM:
+            l2_vm_program();
+            break;
+
+        case L2_ENGINE_TYPE_TOKEN:
+            l2_parse_stmts(g_parser_p->global_scope_p);
+            break;
     }
 }
 
+void l2_absorb_stmt_elif();
+void l2_absorb_formal_param_list();
+
 /* stmts ->
  * | stmt stmts
  * | eof
  *
+ * the stmts are parsed in a loop instead of recursion, so that the long stmts do not overflow the stack
  * */
 l2_stmt_interrupt l2_parse_stmts(l2_scope *scope_p) {
-    _declr_current_token_p
     l2_stmt_interrupt irt = { .type = L2_STMT_NO_INTERRUPT };
 
-    _if_type(L2_TOKEN_TERMINATOR)
-    {
+    while (1) {
+        _if_type(L2_TOKEN_TERMINATOR)
+        {
+            break;
+        }
+        _end
 
-    }
-    _else
-    {
         irt = l2_parse_stmt(scope_p);
 
         if (irt.type == L2_STMT_NOT_STMT) {
             irt.type = L2_STMT_NO_INTERRUPT;
-            //irt.type = L2_STMT_NOT_STMT;
-            return irt;
+            break;
         }
 
         if (irt.type != L2_STMT_NO_INTERRUPT) {
-            /* absorb last stmts */
-            l2_absorb_stmts();
-
-            return irt;
+            /* skip the last stmts of block to its '}' */
+            l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
+            g_parser_p->braces_flag -= 1;
+            break;
         }
 
         /* fix a bug that could make the prompt repeat displaying */
@@ -477,8 +111,10 @@ l2_stmt_interrupt l2_parse_stmts(l2_scope *scope_p) {
             _repl /* prompt */
         }
 
-        /* there is no interrupt */
-        irt = l2_parse_stmts(scope_p);
+        /* the top-level stmt has been executed */
+        if (scope_p == g_parser_p->global_scope_p) {
+            _stream_release
+        }
     }
     return irt;
 }
@@ -510,34 +146,6 @@ void l2_absorb_formal_param_list() {
     } _end
 }
 
-/* stmt_var_def_list1 ->
- * | , id stmt_var_def_list1
- * | , id = expr stmt_var_def_list1
- * | nil
- * */
-void l2_absorb_stmt_var_def_list1() {
-
-    _if_type (L2_TOKEN_COMMA) /* , */
-    {
-        _if_type (L2_TOKEN_IDENTIFIER) /* id */
-        {
-            _if_type (L2_TOKEN_ASSIGN) /* = */
-            {
-                l2_absorb_expr_assign(); /* expr_assign */
-            }
-            _else /* without initialization */
-            {
-
-            }
-
-            /* absorb last part of definition list in recursion */
-            l2_absorb_stmt_var_def_list1();
-
-        } _throw_unexpected_token
-
-    } _end
-}
-
 /* stmt_var_def_list1 ->
  * | , id stmt_var_def_list1
  * | , id = expr stmt_var_def_list1
@@ -558,9 +166,9 @@ void l2_parse_stmt_var_def_list1(l2_scope *scope_p) {
             _get_current_token_p
 
             /* allocate position for the identifier in symbol table */
-            symbol_added = l2_symbol_table_add_symbol_without_initialization(&scope_p->symbol_table_p, current_token_p->u.str.str_p);
+            symbol_added = l2_symbol_table_add_symbol_without_initialization(scope_p, current_token_p->u.id.str_p);
 
-			if (!symbol_added) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.str.str_p);
+			if (!symbol_added) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.id.str_p);
 
             /* rollback operation */
             l2_token_stream_rollback(g_parser_p->token_stream_p);
@@ -570,7 +178,7 @@ void l2_parse_stmt_var_def_list1(l2_scope *scope_p) {
                 boolean symbol_updated;
 
                 l2_token *left_id_p = l2_parse_token_current();
-                char *id_str_p = left_id_p->u.str.str_p;
+                char *id_str_p = left_id_p->u.id.str_p;
 
                 int id_err_line = left_id_p->current_line;
                 int id_err_col = left_id_p->current_col;
@@ -604,7 +212,7 @@ void l2_parse_stmt_var_def_list1(l2_scope *scope_p) {
 
                     if (!symbol_updated) /* if update symbol failed */
                         l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col,
-                                         left_id_p->u.str.str_p);
+                                         id_str_p);
 
                 } _end
 
@@ -623,64 +231,57 @@ void l2_parse_stmt_var_def_list1(l2_scope *scope_p) {
  * | else { stmts }
  * | nil
  *
+ * the rest of elif and else are skipped after a branch has been taken
  * */
-boolean l2_absorb_stmt_elif() {
-
-    _if_keyword(L2_KW_ELIF) /* "elif" */
-    {
-        _if_type (L2_TOKEN_LP) /* ( */
+void l2_absorb_stmt_elif() {
+    while (1) {
+        _if_keyword (L2_KW_ELIF) /* "elif" */
         {
-            l2_absorb_expr();
-
-            _if_type (L2_TOKEN_RP)
-            {
-                /* ) */
-            }_throw_missing_rp
-
-
-            _if_type (L2_TOKEN_LBRACE) /* { */
+            _if_type (L2_TOKEN_LP) /* ( */
             {
-                /* braces flag + 1 */
-                g_parser_p->braces_flag += 1;
+                /* skip the expr without evaluating it */
+                l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
 
-                boolean stmts_flag = l2_absorb_stmts(); /* absorb stmts */
+                _if_type (L2_TOKEN_RP)
+                {
+                    /* ) */
+                } _throw_missing_rp
 
-                _if_type (L2_TOKEN_RBRACE) /* } */
+                _if_type (L2_TOKEN_LBRACE) /* { */
                 {
+                    /* skip the block without parsing it */
+                    l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
 
-                } _throw_missing_rbrace
+                    _if_type (L2_TOKEN_RBRACE) /* } */
+                    {
 
-                if (stmts_flag) {
-                    return l2_absorb_stmt_elif();
-                } else {
-                    return L2_FALSE;
-                }
+                    } _throw_missing_rbrace
 
-            } _throw_unexpected_token
+                } _throw_unexpected_token
 
-        } _throw_unexpected_token
-    }
-    _elif_keyword (L2_KW_ELSE) /* "else" */
-    {
-        _if_type (L2_TOKEN_LBRACE) /* { */
+            } _throw_unexpected_token
+        }
+        _elif_keyword (L2_KW_ELSE) /* "else" */
         {
-            /* braces flag + 1 */
-            g_parser_p->braces_flag += 1;
-
-            boolean stmts_flag = l2_absorb_stmts(); /* absorb stmts */
-
-            _if_type (L2_TOKEN_RBRACE)
+            _if_type (L2_TOKEN_LBRACE) /* { */
             {
-                /* } */
-            } _throw_missing_rbrace
+                /* skip the block without parsing it */
+                l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
 
-            return stmts_flag;
+                _if_type (L2_TOKEN_RBRACE)
+                {
+                    /* } */
+                } _throw_missing_rbrace
 
-        } _throw_unexpected_token
-    }
-    _end
+            } _throw_unexpected_token
 
-    return L2_TRUE;
+            return;
+        }
+        _else
+        {
+            return;
+        }
+    }
 }
 
 /* stmt_elif ->
@@ -739,10 +340,9 @@ l2_stmt_interrupt l2_parse_stmt_elif(l2_scope *scope_p) { /* the scopes in if..e
             } else { /* elif false */
                 _if_type (L2_TOKEN_LBRACE) /* { */
                 {
-                    /* braces flag + 1 */
-                    g_parser_p->braces_flag += 1;
-
-                    irt.type = l2_absorb_stmts(); /* parse stmts */
+                    /* skip the block without parsing it */
+                    l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
+                    irt.type = L2_STMT_NO_INTERRUPT;
 
                     _if_type (L2_TOKEN_RBRACE) /* } */
                     {
@@ -811,8 +411,6 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
 
     l2_stmt_interrupt irt = { .type = L2_STMT_NO_INTERRUPT };
 
-    l2_scope *loop_scope_p;
-
     _if_keyword (L2_KW_BREAK) /* "break" */
     {
         _get_current_token_p
@@ -864,14 +462,17 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
         }
         _else
         {
-            irt.type = L2_STMT_INTERRUPT_RETURN_WITH_VAL; /* has return value */
             irt.col_of_irt_stmt = current_token_p->current_col;
             irt.line_of_irt_stmt = current_token_p->current_line;
-            irt.u.ret_expr_info = l2_eval_expr(scope_p);
 
-            _if (irt.u.ret_expr_info.val_type != L2_EXPR_VAL_NOT_EXPR) {
+            if (!l2_eval_tail_call(scope_p, &irt)) {
+                irt.type = L2_STMT_INTERRUPT_RETURN_WITH_VAL; /* has return value */
+                irt.u.ret_expr_info = l2_eval_expr(scope_p);
 
-            } _throw_unexpected_token
+                _if (irt.u.ret_expr_info.val_type != L2_EXPR_VAL_NOT_EXPR) {
+
+                } _throw_unexpected_token
+            }
 
             _if_type (L2_TOKEN_SEMICOLON)
             {
@@ -889,6 +490,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
     _elif_keyword (L2_KW_PROCEDURE) /* "procedure" */ /* the definition of procedure */
     {
         l2_procedure procedure;
+        procedure.ast_node_p = L2_NULL_PTR;
         _if_type (L2_TOKEN_IDENTIFIER) /* id */
         {
             _get_current_token_p
@@ -906,16 +508,19 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
 
                 _if_type (L2_TOKEN_LBRACE) /* { */
                 {
-                    /* braces flag + 1 */
-                    g_parser_p->braces_flag += 1;
-
-                    irt.type = l2_absorb_stmts();
+                    /* skip the block without parsing it */
+                    l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
+                    irt.type = L2_STMT_NO_INTERRUPT;
 
                     _if_type (L2_TOKEN_RBRACE)
                     {
                         /* absorb '}' */
+                        /* the body is entered again when the procedure is called */
+                        if (_is_stream)
+                            l2_token_stream_pin(g_parser_p->token_stream_p, procedure.entry_pos, l2_token_stream_get_pos(g_parser_p->token_stream_p));
+
                         /* store the procedure information as a symbol into symbol table */
-                        symbol_added = l2_symbol_table_add_symbol_procedure(&scope_p->symbol_table_p, current_token_p->u.str.str_p, procedure);
+                        symbol_added = l2_symbol_table_add_symbol_procedure(scope_p, current_token_p->u.id.str_p, procedure);
 
                     } _throw_missing_rbrace
 
@@ -926,109 +531,13 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
         } _throw_unexpected_token
 
         if (!symbol_added)
-            l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.str.str_p);
+            l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.id.str_p);
 
         return irt;
 
     }
     _elif_keyword (L2_KW_FOR) /* "for" */ /* for-loop */
     {
-        if (_is_repl) {
-            int temp_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
-            /* prove that the for statements is completed */
-            _if_type (L2_TOKEN_LP) /* ( */
-            {
-                /* handle the first expr ( allow to using definition stmt for variable )*/
-                _if_keyword (L2_KW_VAR)
-                {
-                    _if_type (L2_TOKEN_IDENTIFIER) /* id */
-                    {
-                        _get_current_token_p
-
-                        _if_type (L2_TOKEN_ASSIGN) /* = */
-                        {
-                            l2_absorb_expr_assign(); /* absorb expr */
-
-                            /* absorb last part of definition list in recursion */
-                            l2_absorb_stmt_var_def_list1();
-
-                            _if_type (L2_TOKEN_SEMICOLON)
-                            {
-                                /* absorb ';' */
-                            }_throw_missing_semicolon
-
-                        }
-                        _elif_type (L2_TOKEN_SEMICOLON)
-                        {
-                            /* absorb ';' without initializing the variable */
-                        }_throw_unexpected_token
-
-                    }_throw_unexpected_token
-                }
-                _elif_type (L2_TOKEN_SEMICOLON)
-                {
-                    /* this means there is an empty expr in for-loop */
-                    /* also absorb ';' */
-                }
-                _else {
-                    l2_absorb_expr();
-                    _if_type (L2_TOKEN_SEMICOLON)
-                    {
-                        /* absorb ';' */
-                    }_throw_missing_semicolon
-                }
-
-                _if_type (L2_TOKEN_SEMICOLON)
-                {
-                    /* this means there is an empty expr in for-loop,
-                     * and the second expr will have a bool-value with true if it is empty  */
-                    /* also absorb ';' */
-                }
-                _else {
-                    l2_absorb_expr();
-                    _if_type (L2_TOKEN_SEMICOLON)
-                    {
-                        /* absorb ';' */
-                    }_throw_missing_semicolon
-                }
-
-                /* handle the third expr ( absorb it ) */
-                _if_type (L2_TOKEN_RP)
-                {
-                    /* this means there is an empty expr in for-loop */
-                }
-                _else {
-                    /* just absorb the third expr */
-                    l2_absorb_expr();
-
-                    _if_type (L2_TOKEN_RP)
-                    {
-                        /* absorb ')' */
-                    }_throw_missing_rp
-                }
-
-            }_throw_unexpected_token
-
-            /* absorb the for stmt loop structure */
-            _if_type (L2_TOKEN_LBRACE) /* { */
-            {
-                /* braces flag + 1 */
-                g_parser_p->braces_flag += 1;
-
-                l2_absorb_stmts(); /* parse stmts, may parse break or continue*/
-
-                _if_type (L2_TOKEN_RBRACE) /* } */
-                {
-                    /* absorb '}' */
-                }_throw_missing_rbrace
-
-            }_throw_unexpected_token
-            /* prove complete */
-
-            /* restore the position of token stream */
-            l2_token_stream_set_pos(g_parser_p->token_stream_p, temp_pos);
-        }
-
         _get_current_token_p
 
         l2_expr_info second_expr_info;
@@ -1048,7 +557,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                     _get_current_token_p
 
                     /* allocate position for the identifier in symbol table */
-                    l2_symbol_table_add_symbol_without_initialization(&for_init_scope_p->symbol_table_p, current_token_p->u.str.str_p);
+                    l2_symbol_table_add_symbol_without_initialization(for_init_scope_p, current_token_p->u.id.str_p);
 
                     /* rollback operation */
                     l2_token_stream_rollback(g_parser_p->token_stream_p);
@@ -1058,7 +567,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                         boolean symbol_updated;
 
                         l2_token *left_id_p = l2_parse_token_current();
-                        char *id_str_p = left_id_p->u.str.str_p;
+                        char *id_str_p = left_id_p->u.id.str_p;
 
                         int id_err_line = left_id_p->current_line;
                         int id_err_col = left_id_p->current_col;
@@ -1088,7 +597,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                             }
 
                             if (!symbol_updated) /* if update symbol failed */
-                                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                                l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
                         } _end
 
@@ -1130,11 +639,8 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
             loop_entry_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
             __for_loop_entry__:
 
-            /* in this form of variable definition, variable could only take effects to the sub scope */
-            sub_scope_p = l2_scope_create_for_scope(scope_p, L2_SCOPE_CREATE_SUB_SCOPE, loop_entry_pos);
-
-            /* symbol table copy */
-            l2_symbol_table_copy(&sub_scope_p->symbol_table_p, for_init_scope_p->symbol_table_p);
+            /* the body of each iteration runs in a new sub scope of the initialization scope */
+            sub_scope_p = l2_scope_create_for_scope(for_init_scope_p, L2_SCOPE_CREATE_SUB_SCOPE, loop_entry_pos);
 
             _if_type (L2_TOKEN_SEMICOLON)
             {
@@ -1173,8 +679,8 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
             }
             _else
             {
-                /* just absorb the third expr */
-                l2_absorb_expr();
+                /* just skip the third expr to ')' */
+                l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
 
                 _if_type (L2_TOKEN_RP)
                 {
@@ -1202,12 +708,17 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                 switch (irt.type) {
                     case L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL:
                     case L2_STMT_INTERRUPT_RETURN_WITH_VAL:
+                    case L2_STMT_INTERRUPT_TAIL_CALL:
+                    case L2_STMT_NOT_STMT: /* turned into no interrupt by l2_parse_stmts */
+                        break;
+
                     case L2_STMT_INTERRUPT_BREAK:
+                        irt.type = L2_STMT_NO_INTERRUPT; /* the break stops at this loop */
                         break;
 
                     case L2_STMT_INTERRUPT_CONTINUE:
                     case L2_STMT_NO_INTERRUPT:
-                        /* evaluate the third expr */
+                        /* evaluate the third expr, which belongs to the initialization scope rather than the body */
                         l2_token_stream_set_pos(g_parser_p->token_stream_p, third_expr_entry_pos);
 
                         /* handle the third expr ( absorb it ) */
@@ -1217,15 +728,12 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                         }
                         _else
                         {
-                            _if (l2_eval_expr(sub_scope_p).val_type != L2_EXPR_VAL_NOT_EXPR)
+                            _if (l2_eval_expr(for_init_scope_p).val_type != L2_EXPR_VAL_NOT_EXPR)
                             { } _throw_unexpected_token
                         }
 
                         l2_token_stream_set_pos(g_parser_p->token_stream_p, loop_entry_pos);
 
-                        /* apply the modifies in symbol table */
-                        l2_symbol_table_copy(&for_init_scope_p->symbol_table_p, sub_scope_p->symbol_table_p);
-
                         l2_scope_escape_scope(sub_scope_p);
 
                         goto __for_loop_entry__;
@@ -1238,10 +746,9 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
         } else { /* for false */
             _if_type (L2_TOKEN_LBRACE) /* { */
             {
-                /* braces flag + 1 */
-                g_parser_p->braces_flag += 1;
-
-                irt.type = l2_absorb_stmts(); /* parse stmts */
+                /* skip the block without parsing it */
+                l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
+                irt.type = L2_STMT_NO_INTERRUPT;
 
                 _if_type (L2_TOKEN_RBRACE)
                 {
@@ -1260,49 +767,6 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
     }
     _elif_keyword (L2_KW_DO) /* "do" */ /* do...while-loop */
     {
-        if (_is_repl) {
-            int temp_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
-            /* prove that the do-while statements is completed */
-            _if_type (L2_TOKEN_LBRACE) /* { */
-            {
-                /* braces flag + 1 */
-                g_parser_p->braces_flag += 1;
-
-                l2_absorb_stmts(); /* absorb stmts */
-
-                _if_type (L2_TOKEN_RBRACE) /* } */
-                {
-                    /* absorb '}' */
-                }_throw_missing_rbrace
-
-            }_throw_unexpected_token
-
-            _if_keyword (L2_KW_WHILE) /* "while" */
-            {
-                _get_current_token_p
-
-                _if_type (L2_TOKEN_LP) /* ( */
-                {
-                    l2_absorb_expr(); /* absorb expr */
-                }_throw_unexpected_token
-
-                _if_type (L2_TOKEN_RP) /* ) */
-                {
-                    /* absorb ')' */
-                }_throw_missing_rp
-
-                _if_type (L2_TOKEN_SEMICOLON) /* ; */
-                {
-                    /* absorb ';' */
-                }_throw_missing_semicolon
-
-            }_throw_unexpected_token
-            /* prove complete */
-
-            /* restore the position of token stream */
-            l2_token_stream_set_pos(g_parser_p->token_stream_p, temp_pos);
-        }
-
         l2_expr_info expr_info;
 
         int loop_entry_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
@@ -1335,7 +799,9 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                 switch (irt.type) {
                     case L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL:
                     case L2_STMT_INTERRUPT_RETURN_WITH_VAL:
-                        l2_absorb_expr();
+                    case L2_STMT_INTERRUPT_TAIL_CALL:
+                    case L2_STMT_NOT_STMT: /* turned into no interrupt by l2_parse_stmts */
+                        l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
                         _if_type (L2_TOKEN_RP)
                         {
                             /* absorb ')' */
@@ -1348,7 +814,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                         return irt;
 
                     case L2_STMT_INTERRUPT_BREAK:
-                        l2_absorb_expr();
+                        l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
                         _if_type (L2_TOKEN_RP)
                         {
                             /* absorb ')' */
@@ -1358,10 +824,11 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                         {
                             /*  absorb ';' */
                         } _throw_missing_semicolon
+                        irt.type = L2_STMT_NO_INTERRUPT; /* the break stops at this loop */
                         break;
 
                     case L2_STMT_INTERRUPT_CONTINUE:
-                        l2_absorb_expr();
+                        l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
                         _if_type (L2_TOKEN_RP)
                         {
                             /* absorb ')' */
@@ -1409,40 +876,6 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
     }
     _elif_keyword (L2_KW_WHILE) /* "while" */ /* while-loop */
     {
-        if (_is_repl) {
-            int temp_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
-            /* prove that the while statements is completed */
-            _if_type (L2_TOKEN_LP) /* ( */
-            {
-                l2_absorb_expr(); /* absorb expr */
-
-                _if_type (L2_TOKEN_RP)
-                {
-                    /* absorb ')' */
-                }_throw_missing_rp
-
-
-                _if_type (L2_TOKEN_LBRACE) /* { */
-                {
-                    /* braces flag + 1 */
-                    g_parser_p->braces_flag += 1;
-
-                    l2_absorb_stmts(); /* absorb stmts */
-
-                    _if_type (L2_TOKEN_RBRACE)
-                    {
-                        /* absorb '}' */
-                    }_throw_missing_rbrace
-
-                }_throw_unexpected_token
-
-            }_throw_unexpected_token
-            /* prove complete */
-
-            /* restore the position of token stream */
-            l2_token_stream_set_pos(g_parser_p->token_stream_p, temp_pos);
-        }
-
         l2_expr_info expr_info;
         _get_current_token_p
         int loop_entry_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
@@ -1485,9 +918,12 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                     switch (irt.type) {
                         case L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL:
                         case L2_STMT_INTERRUPT_RETURN_WITH_VAL:
+                        case L2_STMT_INTERRUPT_TAIL_CALL:
+                        case L2_STMT_NOT_STMT: /* turned into no interrupt by l2_parse_stmts */
                             return irt;
 
                         case L2_STMT_INTERRUPT_BREAK:
+                            irt.type = L2_STMT_NO_INTERRUPT; /* the break stops at this loop */
                             break;
 
                         case L2_STMT_INTERRUPT_CONTINUE:
@@ -1501,10 +937,9 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
             } else { /* while false */
                 _if_type (L2_TOKEN_LBRACE) /* { */
                 {
-                    /* braces flag + 1 */
-                    g_parser_p->braces_flag += 1;
-
-                    irt.type = l2_absorb_stmts(); /* parse stmts */
+                    /* skip the block without parsing it */
+                    l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
+                    irt.type = L2_STMT_NO_INTERRUPT;
 
                     _if_type (L2_TOKEN_RBRACE)
                     {
@@ -1521,28 +956,6 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
     }
     _elif_type (L2_TOKEN_LBRACE) /* { */
     {
-        if (_is_repl) {
-            int temp_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
-            /* prove that the block is completed */
-            _if_type (L2_TOKEN_LBRACE) /* { */
-            {
-                /* braces flag + 1 */
-                g_parser_p->braces_flag += 1;
-
-                l2_absorb_stmts(); /* absorb stmts */
-
-                _if_type (L2_TOKEN_RBRACE)
-                {
-                    /* absorb '}' */
-                }_throw_missing_rbrace
-
-            }_throw_unexpected_token
-            /* prove complete */
-
-            /* restore the position of token stream */
-            l2_token_stream_set_pos(g_parser_p->token_stream_p, temp_pos);
-        }
-
         /* braces flag + 1 */
         g_parser_p->braces_flag += 1;
 
@@ -1561,40 +974,6 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
     }
     _elif_keyword (L2_KW_IF) /* "if" */
     {
-        if (_is_repl) {
-            int temp_pos = l2_token_stream_get_pos(g_parser_p->token_stream_p);
-            /* prove that the while statements is completed */
-            _if_type (L2_TOKEN_LP) /* ( */
-            {
-                l2_absorb_expr(); /* absorb expr */
-
-                _if_type (L2_TOKEN_RP)
-                {
-                    /* absorb ')' */
-                }_throw_missing_rp
-
-
-                _if_type (L2_TOKEN_LBRACE) /* { */
-                {
-                    /* braces flag + 1 */
-                    g_parser_p->braces_flag += 1;
-
-                    l2_absorb_stmt_elif(); /* absorb stmt_elif */
-
-                    _if_type (L2_TOKEN_RBRACE)
-                    {
-                        /* absorb '}' */
-                    }_throw_missing_rbrace
-
-                }_throw_unexpected_token
-
-            }_throw_unexpected_token
-            /* prove complete */
-
-            /* restore the position of token stream */
-            l2_token_stream_set_pos(g_parser_p->token_stream_p, temp_pos);
-        }
-
         _get_current_token_p
 
         _if_type (L2_TOKEN_LP) /* ( */
@@ -1634,10 +1013,9 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
             } else { /* if false */
                 _if_type (L2_TOKEN_LBRACE) /* { */
                 {
-                    /* braces flag + 1 */
-                    g_parser_p->braces_flag += 1;
-
-                    irt.type = l2_absorb_stmts(); /* parse stmts */
+                    /* skip the block without parsing it */
+                    l2_token_stream_skip_to_end(g_parser_p->token_stream_p);
+                    irt.type = L2_STMT_NO_INTERRUPT;
 
                     _if_type (L2_TOKEN_RBRACE) /* } */
                     {
@@ -1664,9 +1042,9 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
             _get_current_token_p
 
             /* allocate position for the identifier in symbol table */
-			symbol_added = l2_symbol_table_add_symbol_without_initialization(&scope_p->symbol_table_p, current_token_p->u.str.str_p);
+			symbol_added = l2_symbol_table_add_symbol_without_initialization(scope_p, current_token_p->u.id.str_p);
 
-			if (!symbol_added) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.str.str_p);
+			if (!symbol_added) l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_REDEFINED, current_token_p->current_line, current_token_p->current_col, current_token_p->u.id.str_p);
 
             /* rollback operation */
             l2_token_stream_rollback(g_parser_p->token_stream_p);
@@ -1676,7 +1054,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                 boolean symbol_updated;
 
                 l2_token *left_id_p = l2_parse_token_current();
-                char *id_str_p = left_id_p->u.str.str_p;
+                char *id_str_p = left_id_p->u.id.str_p;
 
                 int id_err_line = left_id_p->current_line;
                 int id_err_col = left_id_p->current_col;
@@ -1706,7 +1084,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
                     }
 
                     if (!symbol_updated) /* if update symbol failed */
-                        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, left_id_p->u.str.str_p);
+                        l2_parsing_error(L2_PARSING_ERROR_IDENTIFIER_UNDEFINED, id_err_line, id_err_col, id_str_p);
 
                 } _end
 
@@ -1740,7 +1118,7 @@ l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p) {
 
         switch (right_expr_info.val_type) {
             case L2_EXPR_VAL_TYPE_INTEGER:
-                fprintf(stdout, "%lld\n", right_expr_info.val.integer);
+                fprintf(stdout, "%lld\n", (long long)right_expr_info.val.integer);
                 break;
 
             case L2_EXPR_VAL_TYPE_REAL:
@@ -2,6 +2,7 @@
 #define _L2_PARSE_H_
 
 #define L2_VERSION "v0.3.4" /* version info */
+#define L2_PARSE_STDOUT_BUFF_SIZE 65536 /* the size of output buffer in batch mode */
 
 #include "../l2_tpl/l2_common_type.h"
 #include "l2_token_stream.h"
@@ -9,24 +10,26 @@
 #include "../l2_mem/l2_gc.h"
 #include "l2_eval.h"
 #include "l2_call_stack.h"
+#include "l2_ast.h"
+#include "l2_vm.h"
 
 #define _if_keyword(kw) \
-if (l2_parse_probe_next_token_by_type_and_str(L2_TOKEN_KEYWORD, g_l2_token_keywords[(kw)])) { l2_parse_token_forward(); \
+if (l2_token_stream_match_keyword(g_parser_p->token_stream_p, (kw))) { \
 
 #define _elif_keyword(kw) \
-} else if (l2_parse_probe_next_token_by_type_and_str(L2_TOKEN_KEYWORD, g_l2_token_keywords[(kw)])) { l2_parse_token_forward(); \
+} else if (l2_token_stream_match_keyword(g_parser_p->token_stream_p, (kw))) { \
 
-#define _if_id(c_str) \
-if (l2_parse_probe_next_token_by_type_and_str(L2_TOKEN_IDENTIFIER, (c_str))) { l2_parse_token_forward(); \
+#define _if_id(atom) \
+if (l2_token_stream_match_id(g_parser_p->token_stream_p, (atom))) { \
 
-#define _elif_id(c_str) \
-} else if (l2_parse_probe_next_token_by_type_and_str(L2_TOKEN_IDENTIFIER, (c_str))) { l2_parse_token_forward(); \
+#define _elif_id(atom) \
+} else if (l2_token_stream_match_id(g_parser_p->token_stream_p, (atom))) { \
 
 #define _if_type(type) \
-if (l2_parse_probe_next_token_by_type((type))) { l2_parse_token_forward(); \
+if (l2_token_stream_match(g_parser_p->token_stream_p, (type))) { \
 
 #define _elif_type(type) \
-} else if (l2_parse_probe_next_token_by_type((type))) { l2_parse_token_forward();
+} else if (l2_token_stream_match(g_parser_p->token_stream_p, (type))) {
 
 #define _throw_unexpected_token _throw (L2_PARSING_ERROR_UNEXPECTED_TOKEN, __token_current_p)
 #define _throw_missing_rp _throw (L2_PARSING_ERROR_MISSING_RP)
@@ -34,8 +37,8 @@ if (l2_parse_probe_next_token_by_type((type))) { l2_parse_token_forward(); \
 #define _throw_missing_rbrace _throw (L2_PARSING_ERROR_MISSING_RBRACE)
 #define _throw_missing_colon _throw (L2_PARSING_ERROR_MISSING_COLON)
 
-#define _declr_current_token_p l2_token *current_token_p;
-#define _get_current_token_p current_token_p = l2_parse_token_current();
+#define _declr_current_token_p l2_token current_token, *current_token_p = &current_token; /* a copy, the token vector may be moved while parsing */
+#define _get_current_token_p current_token = *l2_parse_token_current();
 
 #define _throw_expr_not_bool \
 } else l2_parsing_error(L2_PARSING_ERROR_EXPR_NOT_BOOL, current_token_p->current_line, current_token_p->current_col);
@@ -64,26 +67,46 @@ if ((cond)) {
 
 
 #define _repl \
-if (g_parser_p->token_stream_p->char_stream_p->fp == stdin) { \
+if (_is_repl) { \
 fflush(stdout); \
 }
 
 #define _repl_head \
-if (g_parser_p->token_stream_p->char_stream_p->fp == stdin) { \
+if (_is_repl) { \
 fprintf(stdout, "L2 编程语言及其解释器\n当前版本: %s ", L2_VERSION); \
 fprintf(stdout, "L2 解释器命令行, REPL 用户界面\n"); \
 fflush(stdout); \
 }
 
-#define _is_repl (g_parser_p->token_stream_p->char_stream_p->fp == stdin)
+/* the source is read from stdin which is a terminal, the source piped into stdin is executed in batch mode */
+#define _is_repl (g_parser_p->is_repl)
+
+/* the source read from stdin is executed in streaming mode, the tokens and chars executed are released after each stmt */
+#define _is_stream (g_parser_p->token_stream_p->char_stream_p->fp == stdin)
+
+#define _stream_release \
+if (_is_stream) { \
+l2_token_stream_release(g_parser_p->token_stream_p); \
+}
+
+typedef enum _l2_engine_type {
+    L2_ENGINE_TYPE_AST, /* parse the source into ast once, then walk the ast */
+    L2_ENGINE_TYPE_VM, /* compile the ast into bytecode, then run it on the stack vm */
+    L2_ENGINE_TYPE_TOKEN /* parse the token stream while executing */
+}l2_engine_type;
 
 typedef struct _l2_parser {
+    l2_engine_type engine_type;
     l2_token_stream *token_stream_p;
+    l2_intern_pool *intern_pool_p;
     l2_scope *global_scope_p;
     l2_storage *storage_p;
     l2_gc_list *gc_list_p;
     l2_call_stack *call_stack_p;
+    l2_ast *ast_p;
+    l2_vm *vm_p;
     int braces_flag;
+    boolean is_repl;
 }l2_parser;
 
 typedef enum _l2_stmt_interrupt_type {
@@ -92,34 +115,40 @@ typedef enum _l2_stmt_interrupt_type {
     L2_STMT_INTERRUPT_BREAK,
     L2_STMT_INTERRUPT_CONTINUE,
     L2_STMT_INTERRUPT_RETURN_WITH_VAL,
-    L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL
+    L2_STMT_INTERRUPT_RETURN_WITHOUT_VAL,
+    L2_STMT_INTERRUPT_TAIL_CALL /* return with a call, the callee is called after current procedure returns, with the same frame */
 }l2_stmt_interrupt_type;
 
+typedef struct _l2_stmt_tail_call {
+    l2_procedure procedure;
+    l2_expr_info_vector expr_info_vec; /* the values of real parameters, destroyed after they are bound ( token engine ) */
+    struct _l2_ast_node *expr_p; /* the call expr, using by ast engine, whose real parameters are on the top of operand stack */
+}l2_stmt_tail_call;
+
 typedef struct _l2_stmt_interrupt {
     l2_stmt_interrupt_type type;
     int line_of_irt_stmt;
     int col_of_irt_stmt;
     union {
         l2_expr_info ret_expr_info;
+        l2_stmt_tail_call tail_call;
     }u;
 }l2_stmt_interrupt;
 
 extern char *g_l2_token_keywords[];
 
-void l2_parse_initialize(FILE *fp);
+void l2_parse_initialize(FILE *fp, const char *source_path_p, l2_engine_type engine_type, int max_call_depth);
 void l2_parse_finalize();
 
-boolean l2_parse_probe_next_token_by_type_and_str(l2_token_type type, char *str);
 boolean l2_parse_probe_next_token_by_type(l2_token_type type);
 
 void l2_parse();
 l2_stmt_interrupt l2_parse_stmts(l2_scope *scope_p);
 l2_stmt_interrupt l2_parse_stmt(l2_scope *scope_p);
+boolean l2_eval_tail_call(l2_scope *scope_p, l2_stmt_interrupt *irt_p);
 
 void l2_parse_token_forward();
 l2_token *l2_parse_token_current();
 void l2_parse_token_back();
-//int l2_parse_token_stream_get_pos();
-//void l2_parse_token_stream_set_pos(int pos);
 
 #endif
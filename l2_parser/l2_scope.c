@@ -6,44 +6,40 @@
 
 extern l2_parser *g_parser_p;
 
+/* the scope is allocated in its own region */
+l2_scope *l2_scope_new(l2_scope *upper_p, int level, l2_scope_type scope_type) {
+    l2_region region;
+    l2_scope *scope_p;
+
+    l2_region_init(&region);
+    scope_p = l2_region_alloc_with_zero(g_parser_p->storage_p, &region, sizeof(l2_scope));
+    scope_p->region = region;
+    scope_p->guid = scope_p;
+    scope_p->level = level;
+    scope_p->upper_p = upper_p;
+    scope_p->lower_p = L2_NULL_PTR;
+    scope_p->scope_type = scope_type;
+    scope_p->symbol_table_p = l2_symbol_table_create();
+    return scope_p;
+}
+
+void *l2_scope_mem_new(l2_scope *scope_p, l2_mem_size mem_size) {
+    return l2_region_alloc(g_parser_p->storage_p, &scope_p->region, mem_size);
+}
+
 l2_scope *l2_scope_create() {
-    l2_scope *global_p;
-    global_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_scope));
-    global_p->guid = global_p;
-    global_p->level = 0;
-    global_p->upper_p = L2_NULL_PTR;
-    global_p->lower_p = L2_NULL_PTR;
-    global_p->symbol_table_p = l2_symbol_table_create();
-    return global_p;
+    return l2_scope_new(L2_NULL_PTR, 0, L2_SCOPE_TYPE_COMMON);
 }
 
 l2_scope_guid l2_scope_create_scope(l2_scope_guid src, l2_scope_create_flag cf, l2_scope_type scope_type) {
     l2_scope *scope_p = L2_NULL_PTR;
     switch(cf) {
         case L2_SCOPE_CREATE_SUB_SCOPE:
-            if (src->lower_p) {
-                scope_p = src->lower_p;
-                while (scope_p->coor_p) scope_p = scope_p->coor_p;
-
-                scope_p->coor_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_scope));
-                scope_p->coor_p->guid = scope_p->coor_p;
-                scope_p->coor_p->level = src->level + 1;
-                scope_p->coor_p->upper_p = src;
-                scope_p->coor_p->lower_p = L2_NULL_PTR;
-                scope_p->coor_p->scope_type = scope_type;
-                scope_p->coor_p->symbol_table_p = l2_symbol_table_create();
-                return scope_p->coor_p;
-
-            } else {
-                src->lower_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_scope));
-                src->lower_p->guid = src->lower_p;
-                src->lower_p->level = src->level + 1;
-                src->lower_p->upper_p = src;
-                src->lower_p->lower_p = L2_NULL_PTR;
-                src->lower_p->scope_type = scope_type;
-                src->lower_p->symbol_table_p = l2_symbol_table_create();
-                return src->lower_p;
-            }
+            /* the newest sub scope is put in front of its coordinate scopes, it is always the first one to be escaped */
+            scope_p = l2_scope_new(src, src->level + 1, scope_type);
+            scope_p->coor_p = src->lower_p;
+            src->lower_p = scope_p;
+            return scope_p;
 
         case L2_SCOPE_CREATE_COORDINATE_SCOPE:
             if (!src->upper_p)
@@ -52,13 +48,7 @@ l2_scope_guid l2_scope_create_scope(l2_scope_guid src, l2_scope_create_flag cf,
             scope_p = src;
             while (scope_p->coor_p) scope_p = scope_p->coor_p;
 
-            scope_p->coor_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_scope));
-            scope_p->coor_p->guid = scope_p->coor_p;
-            scope_p->coor_p->level = src->level;
-            scope_p->coor_p->upper_p = src->upper_p;
-            scope_p->coor_p->lower_p = L2_NULL_PTR;
-            scope_p->coor_p->scope_type = scope_type;
-            scope_p->coor_p->symbol_table_p = l2_symbol_table_create();
+            scope_p->coor_p = l2_scope_new(src->upper_p, src->level, scope_type);
             return scope_p->coor_p;
 
         default:
@@ -66,37 +56,39 @@ l2_scope_guid l2_scope_create_scope(l2_scope_guid src, l2_scope_create_flag cf,
     }
 }
 
-void l2_scope_coor_finalize_recursion(l2_scope *scope_coor_p) {
-    if (!scope_coor_p) return;
-    l2_scope_coor_finalize_recursion(scope_coor_p->coor_p);
-    l2_scope_lower_finalize_recursion(scope_coor_p->lower_p);
-
-    l2_symbol_table_destroy(scope_coor_p->symbol_table_p);
-    l2_storage_mem_delete(g_parser_p->storage_p, scope_coor_p);
-}
-
-void l2_scope_lower_finalize_recursion(l2_scope *scope_lower_p) {
-    if (!scope_lower_p) return;
-    l2_scope_lower_finalize_recursion(scope_lower_p->lower_p);
-    l2_scope_coor_finalize_recursion(scope_lower_p->coor_p);
-
-    l2_symbol_table_destroy(scope_lower_p->symbol_table_p);
-    l2_storage_mem_delete(g_parser_p->storage_p, scope_lower_p);
+/* release the scope with its coordinate scopes and all of their lower scopes,
+ * the lower scopes are rotated into the coordinate list, so the scope tree is released without recursion
+ * */
+void l2_scope_release_scopes(l2_scope *scope_p) {
+    l2_scope *lower_p, *coor_p;
+
+    while (scope_p) {
+        if (scope_p->lower_p) {
+            lower_p = scope_p->lower_p;
+            scope_p->lower_p = lower_p->coor_p;
+            lower_p->coor_p = scope_p;
+            scope_p = lower_p;
+
+        } else {
+            coor_p = scope_p->coor_p;
+            l2_region_release(g_parser_p->storage_p, &scope_p->region);
+            scope_p = coor_p;
+        }
+    }
 }
 
 void l2_scope_destroy(l2_scope *global_p) {
     l2_assert(global_p, L2_INTERNAL_ERROR_NULL_POINTER);
 
-    l2_scope_lower_finalize_recursion(global_p->lower_p);
-    l2_symbol_table_destroy(global_p->symbol_table_p);
-    l2_storage_mem_delete(g_parser_p->storage_p, global_p);
+    l2_scope_release_scopes(global_p->lower_p);
+    l2_region_release(g_parser_p->storage_p, &global_p->region);
 }
 
-/* when program escape a scope, the symbol table of this scope should be destroyed */
+/* when program escape a scope, the region of this scope ( with its symbol table ) should be released */
 void l2_scope_escape_scope(l2_scope_guid src) {
     l2_assert(src, L2_INTERNAL_ERROR_NULL_POINTER);
-    l2_scope_lower_finalize_recursion(src->lower_p);
-    l2_symbol_table_destroy(src->symbol_table_p);
+    l2_scope_release_scopes(src->lower_p);
+    src->lower_p = L2_NULL_PTR;
 
     l2_scope *scope_upper_p = src->upper_p;
     if (!scope_upper_p) { /* global scope */
@@ -114,7 +106,7 @@ void l2_scope_escape_scope(l2_scope_guid src) {
         scope_p->coor_p = src->coor_p;
     }
 
-    l2_storage_mem_delete(g_parser_p->storage_p, src);
+    l2_region_release(g_parser_p->storage_p, &src->region);
 }
 
 l2_scope_guid l2_scope_create_common_scope(l2_scope_guid src, l2_scope_create_flag cf) {
@@ -3,6 +3,7 @@
 
 #include "../l2_tpl/l2_common_type.h"
 #include "../l2_tpl/l2_vector.h"
+#include "../l2_mem/l2_region.h"
 
 typedef enum _l2_scope_create_flag {
     L2_SCOPE_CREATE_SUB_SCOPE,
@@ -28,10 +29,12 @@ typedef struct _l2_scope {
     union {
         int loop_entry_pos;
     }u;
-    struct _l2_symbol_node *symbol_table_p; /* the symbol table in this scope */
+    struct _l2_symbol_table *symbol_table_p; /* the symbol table in this scope */
+    l2_region region; /* the scope itself and its symbols are allocated in region, which is released when escaping the scope */
 }l2_scope, * l2_scope_guid, l2_scope_mirror;
 
 l2_scope *l2_scope_create();
+void *l2_scope_mem_new(l2_scope *scope_p, l2_mem_size mem_size);
 l2_scope_guid l2_scope_create_scope(l2_scope_guid src, l2_scope_create_flag cf, l2_scope_type scope_type);
 l2_scope_guid l2_scope_create_common_scope(l2_scope_guid src, l2_scope_create_flag cf);
 l2_scope_guid l2_scope_create_for_scope(l2_scope_guid src, l2_scope_create_flag cf, int loop_entry_pos);
@@ -41,8 +44,7 @@ l2_scope_guid l2_scope_create_procedure_scope(l2_scope_guid src, l2_scope_create
 l2_scope_guid l2_scope_find_nearest_loop_scope(l2_scope_guid current_scope);
 l2_scope_guid l2_scope_find_nearest_scope_by_type(l2_scope_guid current_scope, l2_scope_type scope_type);
 
-void l2_scope_lower_finalize_recursion(l2_scope *scope_lower_p);
-void l2_scope_coor_finalize_recursion(l2_scope *scope_coor_p);
+void l2_scope_release_scopes(l2_scope *scope_p);
 void l2_scope_destroy(l2_scope *global_p);
 
 /*
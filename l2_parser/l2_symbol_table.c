@@ -1,205 +1,151 @@
-#include "string.h"
 #include "l2_symbol_table.h"
 #include "../l2_drv/l2_error.h"
 #include "../l2_drv/l2_assert.h"
 #include "l2_scope.h"
 #include "l2_parse.h"
 
+#define L2_SYMBOL_TABLE_INIT_MAX_COUNT 4
+
 extern l2_parser *g_parser_p;
 
-l2_symbol_node *l2_symbol_table_create() {
-    return L2_NULL_PTR;
+l2_symbol_table *l2_symbol_table_create() {
+    return L2_NULL_PTR; /* the table would be allocated when the first symbol is added */
 }
 
-l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_symbol_table(l2_symbol_node *head_p, char *symbol_name) {
-    if (!head_p) return L2_NULL_PTR;
-    if (strcmp(symbol_name, head_p->symbol.symbol_name) == 0) {
-        return head_p;
-    } else {
-        return l2_symbol_table_get_symbol_node_by_name_in_symbol_table(head_p->next, symbol_name);
-    }
+l2_symbol_table *l2_symbol_table_new(l2_scope *scope_p, int max_count) {
+    l2_symbol_table *table_p;
+    table_p = l2_region_alloc_with_zero(g_parser_p->storage_p, &scope_p->region, sizeof(l2_symbol_table) + max_count * 3 * sizeof(l2_symbol_node *));
+    table_p->count = 0;
+    table_p->max_count = max_count;
+    table_p->slots_p = (l2_symbol_node **)(table_p + 1);
+    table_p->buckets_p = table_p->slots_p + max_count;
+    return table_p;
 }
 
-l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_scope(l2_scope *scope_p, char *symbol_name) {
-    return l2_symbol_table_get_symbol_node_by_name_in_symbol_table(scope_p->symbol_table_p, symbol_name);
-}
+/* the buckets are at most half full, so that the probing always stops at an empty bucket */
+void l2_symbol_table_link_bucket(l2_symbol_table *table_p, l2_symbol_node *symbol_node_p) {
+    unsigned int mask = table_p->max_count * 2 - 1, i;
 
-
-l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_upper_scope(l2_scope *scope_p, char *symbol_name) {
-
-    l2_symbol_node *current_p = L2_NULL_PTR;
-    if (!scope_p) return current_p;
-    if ((current_p = l2_symbol_table_get_symbol_node_by_name_in_scope(scope_p, symbol_name)) == L2_NULL_PTR) {
-        return l2_symbol_table_get_symbol_node_by_name_in_upper_scope(scope_p->upper_p, symbol_name);
-    } else {
-        return current_p;
-    }
+    for (i = symbol_node_p->atom & mask; table_p->buckets_p[i]; i = (i + 1) & mask);
+    table_p->buckets_p[i] = symbol_node_p;
 }
 
-boolean l2_symbol_table_add_symbol(l2_symbol_node **head_p, l2_symbol symbol) {
+/* the symbol names are interned, so they are compared by pointer */
+l2_symbol_node *l2_symbol_table_find(l2_symbol_table *table_p, char *symbol_name, l2_atom atom) {
+    unsigned int mask, i;
+    l2_symbol_node *symbol_node_p;
 
-    /* judge the symbol if already defined before */
-    if (l2_symbol_table_get_symbol_node_by_name_in_symbol_table(*head_p, symbol.symbol_name) != L2_NULL_PTR) return L2_FALSE;
-    l2_symbol_node *current_p = *head_p;
-
-    if (*head_p == L2_NULL_PTR) {
-        *head_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-        (*head_p)->next = L2_NULL_PTR;
-        (*head_p)->symbol = symbol;
-        return L2_TRUE;
-    }
+    if (!table_p) return L2_NULL_PTR;
 
-    while (current_p->next) {
-        current_p = current_p->next;
+    mask = table_p->max_count * 2 - 1;
+    for (i = atom & mask; (symbol_node_p = table_p->buckets_p[i]); i = (i + 1) & mask) {
+        if (symbol_node_p->symbol.symbol_name == symbol_name)
+            return symbol_node_p;
     }
-    current_p->next = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-    current_p->next->next = L2_NULL_PTR;
-    current_p->next->symbol = symbol;
-    return L2_TRUE;
+    return L2_NULL_PTR;
 }
 
-boolean l2_symbol_table_add_symbol_without_initialization(l2_symbol_node **head_p, char *symbol_name) {
-
-    /* judge the symbol if already defined before */
-    if (l2_symbol_table_get_symbol_node_by_name_in_symbol_table(*head_p, symbol_name) != L2_NULL_PTR) return L2_FALSE;
-    l2_symbol_node *current_p = *head_p;
-
-    if (*head_p == L2_NULL_PTR) {
-        *head_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-        (*head_p)->next = L2_NULL_PTR;
-        (*head_p)->symbol.symbol_name = symbol_name;
-        (*head_p)->symbol.type = L2_SYMBOL_UNINITIALIZED;
-        return L2_TRUE;
+/* append the symbol into slots without checking redefinition, the table is reallocated if it is full,
+ * the table and symbol nodes are allocated in the region of scope, so the old table is just left in region
+ * */
+l2_symbol_node *l2_symbol_table_append(l2_scope *scope_p, l2_symbol symbol, l2_atom atom) {
+    l2_symbol_table *old_table_p = scope_p->symbol_table_p, *new_table_p;
+    l2_symbol_node *symbol_node_p;
+    int i;
+
+    if (!old_table_p) {
+        scope_p->symbol_table_p = l2_symbol_table_new(scope_p, L2_SYMBOL_TABLE_INIT_MAX_COUNT);
+
+    } else if (old_table_p->count >= old_table_p->max_count) {
+        new_table_p = l2_symbol_table_new(scope_p, old_table_p->max_count * 2);
+        for (i = 0; i < old_table_p->count; i++) {
+            new_table_p->slots_p[i] = old_table_p->slots_p[i];
+            l2_symbol_table_link_bucket(new_table_p, old_table_p->slots_p[i]);
+        }
+        new_table_p->count = old_table_p->count;
+        scope_p->symbol_table_p = new_table_p;
     }
 
-    while (current_p->next) {
-        current_p = current_p->next;
-    }
-    current_p->next = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-    current_p->next->next = L2_NULL_PTR;
-    current_p->next->symbol.symbol_name = symbol_name;
-    current_p->next->symbol.type = L2_SYMBOL_UNINITIALIZED;
-    return L2_TRUE;
-}
-
-boolean l2_symbol_table_add_symbol_integer(l2_symbol_node **head_p, char *symbol_name, int integer) {
+    symbol_node_p = l2_region_alloc(g_parser_p->storage_p, &scope_p->region, sizeof(l2_symbol_node));
+    symbol_node_p->atom = atom;
+    symbol_node_p->symbol = symbol;
 
-    /* judge the symbol if already defined before */
-    if (l2_symbol_table_get_symbol_node_by_name_in_symbol_table(*head_p, symbol_name) != L2_NULL_PTR) return L2_FALSE;
-    l2_symbol_node *current_p = *head_p;
-
-    if (*head_p == L2_NULL_PTR) {
-        *head_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-        (*head_p)->next = L2_NULL_PTR;
-        (*head_p)->symbol.symbol_name = symbol_name;
-        (*head_p)->symbol.type = L2_SYMBOL_TYPE_INTEGER;
-        (*head_p)->symbol.u.integer = integer;
-        return L2_TRUE;
-    }
+    scope_p->symbol_table_p->slots_p[scope_p->symbol_table_p->count++] = symbol_node_p;
+    l2_symbol_table_link_bucket(scope_p->symbol_table_p, symbol_node_p);
+    return symbol_node_p;
+}
 
-    while (current_p->next) {
-        current_p = current_p->next;
-    }
-    current_p->next = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-    current_p->next->next = L2_NULL_PTR;
-    current_p->next->symbol.symbol_name = symbol_name;
-    current_p->next->symbol.type = L2_SYMBOL_TYPE_INTEGER;
-    current_p->next->symbol.u.integer = integer;
-    return L2_TRUE;
+l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_symbol_table(l2_symbol_table *table_p, char *symbol_name) {
+    return l2_symbol_table_find(table_p, symbol_name, l2_intern_atom(symbol_name));
 }
 
-boolean l2_symbol_table_add_symbol_real(l2_symbol_node **head_p, char *symbol_name, double real) {
+l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_scope(l2_scope *scope_p, char *symbol_name) {
+    return l2_symbol_table_get_symbol_node_by_name_in_symbol_table(scope_p->symbol_table_p, symbol_name);
+}
 
-    /* judge the symbol if already defined before */
-    if (l2_symbol_table_get_symbol_node_by_name_in_symbol_table(*head_p, symbol_name) != L2_NULL_PTR) return L2_FALSE;
-    l2_symbol_node *current_p = *head_p;
-
-    if (*head_p == L2_NULL_PTR) {
-        *head_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-        (*head_p)->next = L2_NULL_PTR;
-        (*head_p)->symbol.symbol_name = symbol_name;
-        (*head_p)->symbol.type = L2_SYMBOL_TYPE_REAL;
-        (*head_p)->symbol.u.real = real;
-        return L2_TRUE;
-    }
+l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_upper_scope(l2_scope *scope_p, char *symbol_name) {
+    l2_symbol_node *current_p;
+    l2_atom atom = l2_intern_atom(symbol_name);
 
-    while (current_p->next) {
-        current_p = current_p->next;
+    for (; scope_p; scope_p = scope_p->upper_p) {
+        if ((current_p = l2_symbol_table_find(scope_p->symbol_table_p, symbol_name, atom)) != L2_NULL_PTR)
+            return current_p;
     }
-    current_p->next = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-    current_p->next->next = L2_NULL_PTR;
-    current_p->next->symbol.symbol_name = symbol_name;
-    current_p->next->symbol.type = L2_SYMBOL_TYPE_REAL;
-    current_p->next->symbol.u.real = real;
-    return L2_TRUE;
+    return L2_NULL_PTR;
 }
 
-boolean l2_symbol_table_add_symbol_bool(l2_symbol_node **head_p, char *symbol_name, boolean bool) {
+boolean l2_symbol_table_add_symbol(l2_scope *scope_p, l2_symbol symbol) {
+    l2_atom atom = l2_intern_atom(symbol.symbol_name);
 
     /* judge the symbol if already defined before */
-    if (l2_symbol_table_get_symbol_node_by_name_in_symbol_table(*head_p, symbol_name) != L2_NULL_PTR) return L2_FALSE;
-    l2_symbol_node *current_p = *head_p;
-
-    if (*head_p == L2_NULL_PTR) {
-        *head_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-        (*head_p)->next = L2_NULL_PTR;
-        (*head_p)->symbol.symbol_name = symbol_name;
-        (*head_p)->symbol.type = L2_SYMBOL_TYPE_BOOL;
-        (*head_p)->symbol.u.bool = bool;
-        return L2_TRUE;
-    }
+    if (l2_symbol_table_find(scope_p->symbol_table_p, symbol.symbol_name, atom) != L2_NULL_PTR) return L2_FALSE;
 
-    while (current_p->next) {
-        current_p = current_p->next;
-    }
-    current_p->next = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-    current_p->next->next = L2_NULL_PTR;
-    current_p->next->symbol.symbol_name = symbol_name;
-    current_p->next->symbol.type = L2_SYMBOL_TYPE_BOOL;
-    current_p->next->symbol.u.bool = bool;
+    l2_symbol_table_append(scope_p, symbol, atom);
     return L2_TRUE;
 }
 
-void l2_symbol_table_destroy(l2_symbol_node *head_p) {
-    if (!head_p) return;
-    l2_symbol_table_destroy(head_p->next);
-    l2_storage_mem_delete(g_parser_p->storage_p, head_p);
+/* define the symbol whose redefinition has been checked by resolver,
+ * the slot of symbol is the count of symbols defined before in the scope
+ * */
+l2_symbol_node *l2_symbol_table_define_symbol(l2_scope *scope_p, l2_symbol symbol) {
+    return l2_symbol_table_append(scope_p, symbol, l2_intern_atom(symbol.symbol_name));
 }
 
-boolean l2_symbol_table_add_symbol_procedure(l2_symbol_node **head_p, char *symbol_name, l2_procedure procedure) {
+boolean l2_symbol_table_add_symbol_without_initialization(l2_scope *scope_p, char *symbol_name) {
+    l2_symbol symbol;
+    symbol.symbol_name = symbol_name;
+    symbol.type = L2_SYMBOL_UNINITIALIZED;
+    return l2_symbol_table_add_symbol(scope_p, symbol);
+}
 
-    /* judge the symbol if already defined before */
-    if (l2_symbol_table_get_symbol_node_by_name_in_symbol_table(*head_p, symbol_name) != L2_NULL_PTR) return L2_FALSE;
-    l2_symbol_node *current_p = *head_p;
-
-    if (*head_p == L2_NULL_PTR) {
-        *head_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-        (*head_p)->next = L2_NULL_PTR;
-        (*head_p)->symbol.symbol_name = symbol_name;
-        (*head_p)->symbol.type = L2_SYMBOL_TYPE_PROCEDURE;
-        (*head_p)->symbol.u.procedure = procedure;
-        return L2_TRUE;
-    }
+boolean l2_symbol_table_add_symbol_integer(l2_scope *scope_p, char *symbol_name, int64_t integer) {
+    l2_symbol symbol;
+    symbol.symbol_name = symbol_name;
+    symbol.type = L2_SYMBOL_TYPE_INTEGER;
+    symbol.u.integer = integer;
+    return l2_symbol_table_add_symbol(scope_p, symbol);
+}
 
-    while (current_p->next) {
-        current_p = current_p->next;
-    }
-    current_p->next = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-    current_p->next->next = L2_NULL_PTR;
-    current_p->next->symbol.symbol_name = symbol_name;
-    current_p->next->symbol.type = L2_SYMBOL_TYPE_PROCEDURE;
-    current_p->next->symbol.u.procedure = procedure;
-    return L2_TRUE;
+boolean l2_symbol_table_add_symbol_real(l2_scope *scope_p, char *symbol_name, double real) {
+    l2_symbol symbol;
+    symbol.symbol_name = symbol_name;
+    symbol.type = L2_SYMBOL_TYPE_REAL;
+    symbol.u.real = real;
+    return l2_symbol_table_add_symbol(scope_p, symbol);
 }
 
-void l2_symbol_table_copy(l2_symbol_node **dest_p, l2_symbol_node *src_p) {
-    if (!src_p) {
-        (*dest_p) = L2_NULL_PTR;
-        return;
-    }
+boolean l2_symbol_table_add_symbol_bool(l2_scope *scope_p, char *symbol_name, boolean bool) {
+    l2_symbol symbol;
+    symbol.symbol_name = symbol_name;
+    symbol.type = L2_SYMBOL_TYPE_BOOL;
+    symbol.u.bool = bool;
+    return l2_symbol_table_add_symbol(scope_p, symbol);
+}
 
-    *dest_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_symbol_node));
-    l2_storage_mem_copy(g_parser_p->storage_p, *dest_p, src_p, sizeof(l2_symbol_node));
-    (*dest_p)->next = L2_NULL_PTR;
-    l2_symbol_table_copy(&(*dest_p)->next, src_p->next);
+boolean l2_symbol_table_add_symbol_procedure(l2_scope *scope_p, char *symbol_name, l2_procedure procedure) {
+    l2_symbol symbol;
+    symbol.symbol_name = symbol_name;
+    symbol.type = L2_SYMBOL_TYPE_PROCEDURE;
+    symbol.u.procedure = procedure;
+    return l2_symbol_table_add_symbol(scope_p, symbol);
 }
@@ -5,6 +5,7 @@
 #include "../l2_tpl/l2_vector.h"
 #include "../l2_tpl/l2_string.h"
 #include "l2_scope.h"
+#include "l2_intern.h"
 
 typedef enum _l2_symbol_type {
     L2_SYMBOL_PRESERVE,
@@ -26,13 +27,14 @@ typedef struct _l2_procedure {
      * due to parse both parameter list and procedure content
      * */
     l2_scope *upper_scope_p;
+    struct _l2_ast_node *ast_node_p; /* the definition of procedure in ast, using by ast engine */
 }l2_procedure;
 
 typedef struct _l2_symbol {
     l2_symbol_type type;
-    char *symbol_name;
+    char *symbol_name; /* interned by the intern pool of parser */
     union {
-        int integer;
+        int64_t integer;
         double real;
         boolean bool;
 
@@ -42,24 +44,34 @@ typedef struct _l2_symbol {
 }l2_symbol;
 
 typedef struct _l2_symbol_node {
-    struct _l2_symbol_node *next;
+    l2_atom atom; /* the atom of symbol name */
     l2_symbol symbol;
 
 }l2_symbol_node;
 
-l2_symbol_node *l2_symbol_table_create();
-void l2_symbol_table_destroy(l2_symbol_node *head_p);
-l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_symbol_table(l2_symbol_node *head_p, char *symbol_name);
+/* the symbol table of a scope, which is allocated when the first symbol is added,
+ * the symbols are kept in slots by order of definition, and indexed by atom in an open addressing hash table ( buckets ),
+ * both of them are allocated with the table in a single block, in the region of scope
+ * */
+typedef struct _l2_symbol_table {
+    int count;
+    int max_count; /* the capacity of slots, which is power of 2, and the count of buckets is twice of it */
+    l2_symbol_node **slots_p;
+    l2_symbol_node **buckets_p;
+}l2_symbol_table;
+
+l2_symbol_table *l2_symbol_table_create();
+l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_symbol_table(l2_symbol_table *table_p, char *symbol_name);
 l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_scope(l2_scope *scope_p, char *symbol_name);
 l2_symbol_node *l2_symbol_table_get_symbol_node_by_name_in_upper_scope(l2_scope *scope_p, char *symbol_name);
-void l2_symbol_table_copy(l2_symbol_node **dest_p, l2_symbol_node *src_p);
 
-boolean l2_symbol_table_add_symbol_without_initialization(l2_symbol_node **head_p, char *symbol_name);
-boolean l2_symbol_table_add_symbol_integer(l2_symbol_node **head_p, char *symbol_name, int integer);
-boolean l2_symbol_table_add_symbol_real(l2_symbol_node **head_p, char *symbol_name, double real);
-boolean l2_symbol_table_add_symbol_bool(l2_symbol_node **head_p, char *symbol_name, boolean bool);
-boolean l2_symbol_table_add_symbol_procedure(l2_symbol_node **head_p, char *symbol_name, l2_procedure procedure);
+boolean l2_symbol_table_add_symbol_without_initialization(l2_scope *scope_p, char *symbol_name);
+boolean l2_symbol_table_add_symbol_integer(l2_scope *scope_p, char *symbol_name, int64_t integer);
+boolean l2_symbol_table_add_symbol_real(l2_scope *scope_p, char *symbol_name, double real);
+boolean l2_symbol_table_add_symbol_bool(l2_scope *scope_p, char *symbol_name, boolean bool);
+boolean l2_symbol_table_add_symbol_procedure(l2_scope *scope_p, char *symbol_name, l2_procedure procedure);
 
-boolean l2_symbol_table_add_symbol(l2_symbol_node **head_p, l2_symbol symbol);
+boolean l2_symbol_table_add_symbol(l2_scope *scope_p, l2_symbol symbol);
+l2_symbol_node *l2_symbol_table_define_symbol(l2_scope *scope_p, l2_symbol symbol);
 
 #endif
@@ -0,0 +1,191 @@
+#include "stdio.h"
+#include "string.h"
+#include "l2_token_cache.h"
+#include "l2_parse.h"
+
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+extern l2_parser *g_parser_p;
+
+/* FNV-1a */
+uint64_t l2_token_cache_hash(const char *str_p, int len) {
+    uint64_t hash = 14695981039346656037ULL;
+    int i;
+    for (i = 0; i < len; i++) {
+        hash ^= (unsigned char)str_p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* foo.l2 -> foo.l2c, the other paths are appended with .l2c */
+char *l2_token_cache_path(const char *source_path_p) {
+    int len = strlen(source_path_p);
+    char *cache_path_p = l2_storage_mem_new(g_parser_p->storage_p, len + 5);
+
+    strcpy(cache_path_p, source_path_p);
+    if (len >= 3 && strcmp(source_path_p + len - 3, ".l2") == 0)
+        strcat(cache_path_p, "c");
+    else
+        strcat(cache_path_p, ".l2c");
+    return cache_path_p;
+}
+
+void l2_token_cache_make_header(l2_token_stream *token_stream_p, l2_token_cache_header *header_p) {
+    l2_char_stream *char_stream_p = token_stream_p->char_stream_p;
+
+    memset(header_p, 0, sizeof(l2_token_cache_header));
+    strcpy(header_p->magic, L2_TOKEN_CACHE_MAGIC);
+    header_p->byte_order = L2_TOKEN_CACHE_BYTE_ORDER;
+    strncpy(header_p->version, L2_VERSION, L2_TOKEN_CACHE_VERSION_LEN - 1);
+    header_p->format = L2_TOKEN_CACHE_FORMAT;
+    header_p->payload_size = sizeof(l2_token_payload);
+    header_p->source_hash = l2_token_cache_hash(char_stream_p->chars_p, char_stream_p->chars_size);
+    header_p->source_size = char_stream_p->chars_size;
+}
+
+/* the whole source must have been read into char stream, and no token has been lexed,
+ * the cache file is read by a single block, and the strs are interned once for each of them instead of each token
+ * */
+boolean l2_token_cache_load(l2_token_stream *token_stream_p) {
+    l2_char_stream *char_stream_p = token_stream_p->char_stream_p;
+    l2_token_cache_header header, expected_header;
+    FILE *fp;
+    long file_size;
+    char *data_p = L2_NULL_PTR, *p, **strs_p = L2_NULL_PTR;
+    int *line_starts_p;
+    int i, len;
+    boolean loaded = L2_FALSE;
+
+    if (!(fp = fopen(token_stream_p->cache_path_p, "rb"))) return L2_FALSE;
+
+    l2_token_cache_make_header(token_stream_p, &expected_header);
+
+    if (fread(&header, sizeof(header), 1, fp) != 1
+        || memcmp(header.magic, expected_header.magic, sizeof(header.magic)) != 0
+        || header.byte_order != expected_header.byte_order
+        || memcmp(header.version, expected_header.version, sizeof(header.version)) != 0
+        || header.format != expected_header.format
+        || header.payload_size != expected_header.payload_size
+        || header.source_hash != expected_header.source_hash
+        || header.source_size != expected_header.source_size
+        || header.tokens_count <= 0 || header.lines <= 0 || header.strs_count < 0 || header.strs_size < 0)
+        goto end;
+
+    /* the size of cache file must be exactly the same, so the cache which is partially written is not used */
+    file_size = (long)header.tokens_count * (sizeof(l2_token_payload) + sizeof(int) + sizeof(unsigned char))
+                + (long)header.lines * sizeof(int) + header.strs_size;
+    data_p = l2_storage_mem_new(g_parser_p->storage_p, file_size + 1);
+    if (fread(data_p, 1, file_size + 1, fp) != (size_t)file_size) goto end;
+    data_p[file_size] = '\0'; /* the strs never go over the end */
+
+    p = data_p;
+    l2_token_stream_reserve(token_stream_p, header.tokens_count);
+    memcpy(token_stream_p->payloads_p, p, header.tokens_count * sizeof(l2_token_payload));
+    p += header.tokens_count * sizeof(l2_token_payload);
+    memcpy(token_stream_p->poses_p, p, header.tokens_count * sizeof(int));
+    p += header.tokens_count * sizeof(int);
+    line_starts_p = (int *)p;
+    p += header.lines * sizeof(int);
+    memcpy(token_stream_p->types_p, p, header.tokens_count * sizeof(unsigned char));
+    p += header.tokens_count * sizeof(unsigned char);
+
+    /* the index of str in cache is replaced with the interned str */
+    strs_p = l2_storage_mem_new(g_parser_p->storage_p, (header.strs_count + 1) * sizeof(char *));
+    for (i = 0; i < header.strs_count; i++) {
+        len = strlen(p);
+        strs_p[i] = l2_intern_pool_intern(g_parser_p->intern_pool_p, p, len);
+        p += len + 1;
+    }
+
+    for (i = 0; i < header.tokens_count; i++) {
+        /* the type out of range is never written, the cache is corrupt */
+        if (token_stream_p->types_p[i] > L2_TOKEN_SEMICOLON) goto end;
+
+        if (token_stream_p->types_p[i] == L2_TOKEN_IDENTIFIER || token_stream_p->types_p[i] == L2_TOKEN_STRING_LITERAL) {
+            if (token_stream_p->payloads_p[i].integer < 0 || token_stream_p->payloads_p[i].integer >= header.strs_count) goto end;
+            token_stream_p->payloads_p[i].str_p = strs_p[token_stream_p->payloads_p[i].integer];
+        }
+    }
+
+    if (token_stream_p->types_p[header.tokens_count - 1] != L2_TOKEN_TERMINATOR) goto end;
+
+    /* the jumps are not kept in cache, they are linked again from the types */
+    for (i = 0; i < header.tokens_count; i++)
+        l2_token_stream_link(token_stream_p, i);
+
+    l2_char_stream_set_line_starts(char_stream_p, line_starts_p, header.lines);
+    token_stream_p->tokens_count = header.tokens_count;
+    loaded = L2_TRUE;
+
+end:
+    if (strs_p) l2_storage_mem_delete(g_parser_p->storage_p, strs_p);
+    if (data_p) l2_storage_mem_delete(g_parser_p->storage_p, data_p);
+    fclose(fp);
+    return loaded;
+}
+
+/* the tokens lexed from the whole source are written into cache file,
+ * it is written into a temporary file first ( named with the pid, so the interpreters running the same source at the same time never write into the same one ),
+ * which is renamed as the cache file when complete
+ * */
+void l2_token_cache_save(l2_token_stream *token_stream_p) {
+    l2_char_stream *char_stream_p = token_stream_p->char_stream_p;
+    l2_intern_pool *pool_p = g_parser_p->intern_pool_p;
+    l2_token_cache_header header;
+    l2_token_payload payload;
+    char *tmp_path_p;
+    FILE *fp;
+    int i;
+    boolean written = L2_TRUE;
+
+    l2_token_cache_make_header(token_stream_p, &header);
+    header.tokens_count = token_stream_p->tokens_count;
+    header.lines = char_stream_p->lines;
+    header.strs_count = pool_p->count;
+    for (i = 0; i < pool_p->count; i++)
+        header.strs_size += strlen(l2_intern_pool_get_str(pool_p, i)) + 1;
+
+    /* <cache path>.<pid>.tmp */
+    tmp_path_p = l2_storage_mem_new(g_parser_p->storage_p, strlen(token_stream_p->cache_path_p) + 32);
+    sprintf(tmp_path_p, "%s.%ld.tmp", token_stream_p->cache_path_p, (long)getpid());
+
+    if (!(fp = fopen(tmp_path_p, "wb"))) {
+        l2_storage_mem_delete(g_parser_p->storage_p, tmp_path_p);
+        return;
+    }
+
+    written = written && fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (i = 0; i < token_stream_p->tokens_count && written; i++) {
+        payload = token_stream_p->payloads_p[i];
+        if (token_stream_p->types_p[i] == L2_TOKEN_IDENTIFIER || token_stream_p->types_p[i] == L2_TOKEN_STRING_LITERAL) {
+            memset(&payload, 0, sizeof(payload));
+            payload.integer = l2_intern_atom(token_stream_p->payloads_p[i].str_p);
+        }
+        written = fwrite(&payload, sizeof(payload), 1, fp) == 1;
+    }
+    written = written && fwrite(token_stream_p->poses_p, sizeof(int), token_stream_p->tokens_count, fp) == (size_t)token_stream_p->tokens_count;
+    written = written && fwrite(char_stream_p->line_starts_p, sizeof(int), char_stream_p->lines, fp) == (size_t)char_stream_p->lines;
+    written = written && fwrite(token_stream_p->types_p, sizeof(unsigned char), token_stream_p->tokens_count, fp) == (size_t)token_stream_p->tokens_count;
+    for (i = 0; i < pool_p->count && written; i++)
+        written = fputs(l2_intern_pool_get_str(pool_p, i), fp) >= 0 && fputc('\0', fp) != EOF;
+
+    if (fclose(fp) != 0) written = L2_FALSE;
+
+    if (written) {
+        /* rename could not replace the existing file on some platforms */
+        if (rename(tmp_path_p, token_stream_p->cache_path_p) != 0) {
+            remove(token_stream_p->cache_path_p);
+            if (rename(tmp_path_p, token_stream_p->cache_path_p) != 0) remove(tmp_path_p);
+        }
+    } else {
+        remove(tmp_path_p);
+    }
+
+    l2_storage_mem_delete(g_parser_p->storage_p, tmp_path_p);
+}
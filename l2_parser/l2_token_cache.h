@@ -0,0 +1,34 @@
+#ifndef _L2_TOKEN_CACHE_H_
+#define _L2_TOKEN_CACHE_H_
+
+#include "../l2_tpl/l2_common_type.h"
+#include "l2_token_stream.h"
+
+#define L2_TOKEN_CACHE_MAGIC "L2C"
+#define L2_TOKEN_CACHE_VERSION_LEN 16
+#define L2_TOKEN_CACHE_FORMAT 3 /* increased when the layout of cache is changed */
+#define L2_TOKEN_CACHE_BYTE_ORDER 0x01020304 /* written in native byte order, it is read as another value on the platform of another byte order */
+
+/* the cache file ( source path with suffix 'c', e.g. foo.l2c ) keeps the tokens lexed from source,
+ * it is used only if the hash and size of source and the version of interpreter are all the same,
+ * the header is followed by payloads, poses, line starts, types and the strs ( each ends with '\0' )
+ * */
+typedef struct _l2_token_cache_header {
+    char magic[4];
+    unsigned int byte_order;
+    char version[L2_TOKEN_CACHE_VERSION_LEN];
+    unsigned int format;
+    unsigned int payload_size; /* the size of l2_token_payload, the cache written on another platform is not used */
+    uint64_t source_hash;
+    int source_size;
+    int tokens_count;
+    int lines;
+    int strs_count;
+    int strs_size;
+}l2_token_cache_header;
+
+char *l2_token_cache_path(const char *source_path_p);
+boolean l2_token_cache_load(l2_token_stream *token_stream_p);
+void l2_token_cache_save(l2_token_stream *token_stream_p);
+
+#endif
@@ -1,9 +1,19 @@
 #include "stdlib.h"
+#include "string.h"
 #include "l2_token_stream.h"
 #include "../l2_drv/l2_error.h"
 #include "../l2_drv/l2_assert.h"
 #include "../l2_drv/l2_warning.h"
 #include "l2_cast.h"
+#include "l2_parse.h"
+#include "l2_token_cache.h"
+
+extern l2_parser *g_parser_p;
+
+#define L2_TOKEN_STREAM_INIT_MAX_COUNT 64
+
+void l2_token_stream_fill(l2_token_stream *token_stream_p);
+void l2_token_stream_lex(l2_token_stream *token_stream_p);
 
 char *g_l2_token_keywords[] = {
         "true",
@@ -22,47 +32,316 @@ char *g_l2_token_keywords[] = {
         "eval"
 };
 
-l2_token_stream *l2_token_stream_create(FILE *fp) {
+/* the perfect hash of keywords, no two keywords have the same hash */
+#define L2_TOKEN_KEYWORD_HASH(str_p, len) (((unsigned char)(str_p)[0] + (unsigned char)(str_p)[(len) - 1] + (len) * 3) & 0x1f)
+#define L2_TOKEN_KEYWORD_MAX_LEN 8
+
+const l2_keyword g_l2_token_keyword_slots[0x20] = {
+        L2_KW_CONTINUE, L2_KW_FOR, L2_KW_NOT_KEYWORD, L2_KW_NOT_KEYWORD,
+        L2_KW_NOT_KEYWORD, L2_KW_TRUE, L2_KW_NOT_KEYWORD, L2_KW_NOT_KEYWORD,
+        L2_KW_NOT_KEYWORD, L2_KW_NOT_KEYWORD, L2_KW_NOT_KEYWORD, L2_KW_WHILE,
+        L2_KW_NOT_KEYWORD, L2_KW_NOT_KEYWORD, L2_KW_NOT_KEYWORD, L2_KW_NOT_KEYWORD,
+        L2_KW_NOT_KEYWORD, L2_KW_VAR, L2_KW_RETURN, L2_KW_NOT_KEYWORD,
+        L2_KW_NOT_KEYWORD, L2_KW_IF, L2_KW_ELSE, L2_KW_ELIF,
+        L2_KW_NOT_KEYWORD, L2_KW_DO, L2_KW_FALSE, L2_KW_NOT_KEYWORD,
+        L2_KW_BREAK, L2_KW_EVAL, L2_KW_NOT_KEYWORD, L2_KW_PROCEDURE
+};
+
+l2_token_stream *l2_token_stream_create(FILE *fp, const char *source_path_p) {
     l2_token_stream *token_stream_p = malloc(sizeof(l2_token_stream));
     l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    l2_vector_create(&token_stream_p->token_vector, sizeof(l2_token));
-    token_stream_p->token_vector_current_pos = 0;
+    token_stream_p->tokens_count = 0;
+    token_stream_p->tokens_max_count = L2_TOKEN_STREAM_INIT_MAX_COUNT;
+    token_stream_p->types_p = l2_storage_mem_new(g_parser_p->storage_p, L2_TOKEN_STREAM_INIT_MAX_COUNT * sizeof(unsigned char));
+    token_stream_p->payloads_p = l2_storage_mem_new(g_parser_p->storage_p, L2_TOKEN_STREAM_INIT_MAX_COUNT * sizeof(l2_token_payload));
+    token_stream_p->poses_p = l2_storage_mem_new(g_parser_p->storage_p, L2_TOKEN_STREAM_INIT_MAX_COUNT * sizeof(int));
+    token_stream_p->jumps_p = l2_storage_mem_new(g_parser_p->storage_p, L2_TOKEN_STREAM_INIT_MAX_COUNT * sizeof(int));
+    token_stream_p->tokens_current_pos = 0;
+    token_stream_p->tokens_base = 0;
+    l2_token_range_vector_create(&token_stream_p->pinned_ranges);
+    l2_token_segment_vector_create(&token_stream_p->segments);
+    token_stream_p->segment_hint = 0;
+    int_stack_create(&token_stream_p->opens);
     token_stream_p->char_stream_p = l2_char_stream_create(fp);
+    token_stream_p->cache_path_p = source_path_p ? l2_token_cache_path(source_path_p) : L2_NULL_PTR;
     return token_stream_p;
 }
 
 void l2_token_stream_destroy(l2_token_stream *token_stream_p) {
-    l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    /*
     int i;
-    l2_token *tp;
-    for (i = 0; i < token_stream_p->token_vector.size; i++) {
-        tp = (l2_token *)l2_vector_at(&token_stream_p->token_vector, i);
-        l2_assert(tp, L2_INTERNAL_ERROR_NULL_POINTER);
-        if (tp->type == L2_TOKEN_IDENTIFIER || tp->type == L2_TOKEN_STRING_LITERAL)
-            l2_string_destroy(&tp->u.str);
-    }
-    */
-    l2_vector_destroy(&token_stream_p->token_vector);
-    token_stream_p->token_vector_current_pos = 0;
+    l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
+    for (i = 0; i < (int)token_stream_p->segments.size; i++)
+        l2_storage_mem_delete(g_parser_p->storage_p, l2_token_segment_vector_at(&token_stream_p->segments, i)->tokens_p);
+    l2_token_segment_vector_destroy(&token_stream_p->segments);
+    l2_token_range_vector_destroy(&token_stream_p->pinned_ranges);
+    int_stack_destroy(&token_stream_p->opens);
+    l2_storage_mem_delete(g_parser_p->storage_p, token_stream_p->types_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, token_stream_p->payloads_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, token_stream_p->poses_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, token_stream_p->jumps_p);
+    if (token_stream_p->cache_path_p)
+        l2_storage_mem_delete(g_parser_p->storage_p, token_stream_p->cache_path_p);
+    token_stream_p->tokens_current_pos = 0;
     l2_char_stream_destroy(token_stream_p->char_stream_p);
     free(token_stream_p);
 }
 
+void l2_token_stream_reserve(l2_token_stream *token_stream_p, int max_count) {
+    if (max_count <= token_stream_p->tokens_max_count) return;
+
+    token_stream_p->types_p = l2_storage_mem_renew(g_parser_p->storage_p, token_stream_p->types_p, max_count * sizeof(unsigned char));
+    token_stream_p->payloads_p = l2_storage_mem_renew(g_parser_p->storage_p, token_stream_p->payloads_p, max_count * sizeof(l2_token_payload));
+    token_stream_p->poses_p = l2_storage_mem_renew(g_parser_p->storage_p, token_stream_p->poses_p, max_count * sizeof(int));
+    token_stream_p->jumps_p = l2_storage_mem_renew(g_parser_p->storage_p, token_stream_p->jumps_p, max_count * sizeof(int));
+    token_stream_p->tokens_max_count = max_count;
+}
+
+/* the closing bracket must match the last open one, otherwise the closing bracket of the open one is missing,
+ * which is reported at the token before it ( where the parser expects the closing one )
+ * */
+void l2_token_stream_check_closing(l2_token_stream *token_stream_p, l2_token *t) {
+    int open_pos;
+    l2_token prev_token;
+
+    if (t->type != L2_TOKEN_RBRACE && t->type != L2_TOKEN_RP && t->type != L2_TOKEN_RBRACKET) return;
+    if (token_stream_p->opens.size <= 0) return;
+
+    open_pos = *int_stack_back(&token_stream_p->opens);
+    if (open_pos < token_stream_p->tokens_base) return; /* the open one has been released */
+
+    l2_token_stream_decode(token_stream_p, token_stream_p->tokens_count - 1, &prev_token);
+
+    switch (token_stream_p->types_p[open_pos - token_stream_p->tokens_base]) {
+        case L2_TOKEN_LP:
+            if (t->type != L2_TOKEN_RP)
+                l2_parsing_error(L2_PARSING_ERROR_MISSING_RP, prev_token.current_line, prev_token.current_col);
+            break;
+
+        case L2_TOKEN_LBRACE:
+            if (t->type != L2_TOKEN_RBRACE)
+                l2_parsing_error(L2_PARSING_ERROR_MISSING_RBRACE, prev_token.current_line, prev_token.current_col);
+            break;
+
+        default: /* [ */
+            if (t->type != L2_TOKEN_RBRACKET)
+                l2_parsing_error(L2_PARSING_ERROR_UNEXPECTED_TOKEN, t->current_line, t->current_col, t);
+    }
+}
+
+void l2_token_stream_append(l2_token_stream *token_stream_p, l2_token *t) {
+    int i = token_stream_p->tokens_count - token_stream_p->tokens_base;
+
+    if (i >= token_stream_p->tokens_max_count)
+        l2_token_stream_reserve(token_stream_p, token_stream_p->tokens_max_count * 2);
+
+    token_stream_p->types_p[i] = t->type;
+    token_stream_p->poses_p[i] = t->current_pos_at_stream;
+
+    switch (t->type) {
+        case L2_TOKEN_KEYWORD: token_stream_p->payloads_p[i].keyword = t->u.keyword; break;
+        case L2_TOKEN_IDENTIFIER: token_stream_p->payloads_p[i].str_p = t->u.id.str_p; break;
+        case L2_TOKEN_STRING_LITERAL: token_stream_p->payloads_p[i].str_p = t->u.str_p; break;
+        case L2_TOKEN_REAL_LITERAL: token_stream_p->payloads_p[i].real = t->u.real; break;
+        case L2_TOKEN_INTEGER_LITERAL: token_stream_p->payloads_p[i].integer = t->u.integer; break;
+        default: break;
+    }
+
+    l2_token_stream_check_closing(token_stream_p, t);
+    l2_token_stream_link(token_stream_p, token_stream_p->tokens_count);
+    token_stream_p->tokens_count += 1;
+}
+
+/* link the jump of the token at pos ( which is the last one lexed ) with the brackets not closed yet */
+void l2_token_stream_link(l2_token_stream *token_stream_p, int pos) {
+    int *jumps_p = token_stream_p->jumps_p - token_stream_p->tokens_base, open_pos;
+
+    switch (token_stream_p->types_p[pos - token_stream_p->tokens_base]) {
+        case L2_TOKEN_LBRACE:
+        case L2_TOKEN_LP:
+        case L2_TOKEN_LBRACKET:
+            jumps_p[pos] = L2_TOKEN_NO_JUMP;
+            int_stack_push_back(&token_stream_p->opens, pos);
+            return;
+
+        case L2_TOKEN_RBRACE:
+        case L2_TOKEN_RP:
+        case L2_TOKEN_RBRACKET:
+            if (token_stream_p->opens.size > 0) {
+                open_pos = *int_stack_pop(&token_stream_p->opens);
+                if (open_pos >= token_stream_p->tokens_base) jumps_p[open_pos] = pos;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    jumps_p[pos] = token_stream_p->opens.size > 0 ? *int_stack_back(&token_stream_p->opens) : L2_TOKEN_NO_JUMP;
+}
+
+/* the token kept in segment, the pos is before tokens_base */
+l2_token *l2_token_stream_kept_token(l2_token_stream *token_stream_p, int pos) {
+    l2_token_segment *segments_p = token_stream_p->segments.vector_p;
+    int i = token_stream_p->segment_hint, low, high, mid;
+
+    if (i >= (int)token_stream_p->segments.size || segments_p[i].range.begin_pos > pos || segments_p[i].range.end_pos <= pos) {
+        /* find the last segment which begins before pos */
+        low = 0;
+        high = token_stream_p->segments.size - 1;
+        while (low < high) {
+            mid = (low + high + 1) / 2;
+            if (segments_p[mid].range.begin_pos <= pos) low = mid;
+            else high = mid - 1;
+        }
+        i = token_stream_p->segment_hint = low;
+        l2_assert(i < (int)token_stream_p->segments.size && segments_p[i].range.begin_pos <= pos && pos < segments_p[i].range.end_pos, L2_INTERNAL_ERROR_OUT_OF_RANGE);
+    }
+
+    return &segments_p[i].tokens_p[pos - segments_p[i].range.begin_pos];
+}
+
+/* decode the token at pos ( starts from 0 ) into t */
+l2_token *l2_token_stream_decode(l2_token_stream *token_stream_p, int pos, l2_token *t) {
+    l2_token_payload *payload_p;
+
+    if (pos < token_stream_p->tokens_base) {
+        *t = *l2_token_stream_kept_token(token_stream_p, pos);
+        return t;
+    }
+
+    pos -= token_stream_p->tokens_base;
+    payload_p = &token_stream_p->payloads_p[pos];
+    t->type = token_stream_p->types_p[pos];
+    t->current_pos_at_stream = token_stream_p->poses_p[pos];
+    t->jump_pos = token_stream_p->jumps_p[pos];
+
+    switch (t->type) {
+        case L2_TOKEN_KEYWORD: t->u.keyword = payload_p->keyword; break;
+        case L2_TOKEN_IDENTIFIER: t->u.id.str_p = payload_p->str_p; t->u.id.atom = l2_intern_atom(payload_p->str_p); break;
+        case L2_TOKEN_STRING_LITERAL: t->u.str_p = payload_p->str_p; break;
+        case L2_TOKEN_REAL_LITERAL: t->u.real = payload_p->real; break;
+        case L2_TOKEN_INTEGER_LITERAL: t->u.integer = payload_p->integer; break;
+        default: break;
+    }
+
+    l2_char_stream_get_line_col(token_stream_p->char_stream_p, t->current_pos_at_stream, &t->current_line, &t->current_col);
+    return t;
+}
+
+/* the returned token is overwritten by the next call */
 l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
     l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
 
-    if (token_stream_p->token_vector_current_pos < token_stream_p->token_vector.size) {
-        token_stream_p->token_vector_current_pos += 1;
-        return (l2_token *)l2_vector_at(&token_stream_p->token_vector, token_stream_p->token_vector_current_pos - 1);
+    if (token_stream_p->tokens_current_pos >= token_stream_p->tokens_count)
+        l2_token_stream_fill(token_stream_p);
+
+    token_stream_p->tokens_current_pos += 1;
+    return l2_token_stream_decode(token_stream_p, token_stream_p->tokens_current_pos - 1, &token_stream_p->next_token);
+}
+
+/* the type of the nth token after current position ( n starts from 1 ), the position is not changed */
+l2_token_type l2_token_stream_peek_type(l2_token_stream *token_stream_p, int n) {
+    int pos = token_stream_p->tokens_current_pos + n - 1;
+
+    while (pos >= token_stream_p->tokens_count)
+        l2_token_stream_fill(token_stream_p);
+
+    if (pos < token_stream_p->tokens_base)
+        return l2_token_stream_kept_token(token_stream_p, pos)->type;
+
+    return token_stream_p->types_p[pos - token_stream_p->tokens_base];
+}
+
+/* the returned token is overwritten by the next call */
+l2_token *l2_token_stream_peek_token(l2_token_stream *token_stream_p, int n) {
+    l2_token_stream_peek_type(token_stream_p, n);
+    return l2_token_stream_decode(token_stream_p, token_stream_p->tokens_current_pos + n - 1, &token_stream_p->peek_token);
+}
+
+/* forward if the next token has the type */
+boolean l2_token_stream_match(l2_token_stream *token_stream_p, l2_token_type type) {
+    if (l2_token_stream_peek_type(token_stream_p, 1) != type) return L2_FALSE;
+    token_stream_p->tokens_current_pos += 1;
+    return L2_TRUE;
+}
+
+/* forward if the next token is the keyword */
+boolean l2_token_stream_match_keyword(l2_token_stream *token_stream_p, l2_keyword keyword) {
+    int pos = token_stream_p->tokens_current_pos;
+
+    if (l2_token_stream_peek_type(token_stream_p, 1) != L2_TOKEN_KEYWORD) return L2_FALSE;
+    if (pos < token_stream_p->tokens_base) {
+        if (l2_token_stream_kept_token(token_stream_p, pos)->u.keyword != keyword) return L2_FALSE;
+    } else if (token_stream_p->payloads_p[pos - token_stream_p->tokens_base].keyword != keyword) {
+        return L2_FALSE;
+    }
+    token_stream_p->tokens_current_pos += 1;
+    return L2_TRUE;
+}
+
+/* forward if the next token is the identifier, whose interned str has the atom */
+boolean l2_token_stream_match_id(l2_token_stream *token_stream_p, l2_atom atom) {
+    int pos = token_stream_p->tokens_current_pos;
+
+    if (l2_token_stream_peek_type(token_stream_p, 1) != L2_TOKEN_IDENTIFIER) return L2_FALSE;
+    if (pos < token_stream_p->tokens_base) {
+        if (l2_token_stream_kept_token(token_stream_p, pos)->u.id.atom != atom) return L2_FALSE;
+    } else if (l2_intern_atom(token_stream_p->payloads_p[pos - token_stream_p->tokens_base].str_p) != atom) {
+        return L2_FALSE;
+    }
+    token_stream_p->tokens_current_pos += 1;
+    return L2_TRUE;
+}
+
+/* the input of repl is complete if all the brackets are closed and the token lexed last ends a stmt */
+boolean l2_token_stream_is_complete(l2_token_stream *token_stream_p) {
+    switch (token_stream_p->types_p[token_stream_p->tokens_count - token_stream_p->tokens_base - 1]) {
+        case L2_TOKEN_RBRACE:
+        case L2_TOKEN_SEMICOLON:
+            return token_stream_p->opens.size == 0;
+
+        case L2_TOKEN_TERMINATOR:
+            return L2_TRUE;
+
+        default:
+            return L2_FALSE;
+    }
+}
+
+/* the source of file is lexed at once, or loaded from the token cache if the source is not changed,
+ * the repl lexes until the input is complete, so that the block is read entirely before it is executed,
+ * the source piped into stdin is lexed a single token each time
+ * */
+void l2_token_stream_fill(l2_token_stream *token_stream_p) {
+    boolean is_whole_source = token_stream_p->tokens_count == 0 && token_stream_p->cache_path_p;
+
+    if (token_stream_p->char_stream_p->fp == stdin) {
+        do {
+            l2_token_stream_lex(token_stream_p);
+        } while (g_parser_p->is_repl && !l2_token_stream_is_complete(token_stream_p));
+        return;
     }
 
+    if (is_whole_source) {
+        l2_char_stream_read_all(token_stream_p->char_stream_p);
+        if (l2_token_cache_load(token_stream_p)) return;
+    }
+
+    do {
+        l2_token_stream_lex(token_stream_p);
+    } while (token_stream_p->types_p[token_stream_p->tokens_count - token_stream_p->tokens_base - 1] != L2_TOKEN_TERMINATOR);
+
+    if (is_whole_source) l2_token_cache_save(token_stream_p);
+}
 
+/* lex the next token from char stream and append it */
+void l2_token_stream_lex(l2_token_stream *token_stream_p) {
+    l2_char_stream *char_stream_p = token_stream_p->char_stream_p;
     l2_token t = { 0 };
     int fa_state = 0x0;
+    int literal_begin = 0; /* the identifiers and number literals are taken straight from the chars in buffer */
     char ch = 0;
-    l2_string token_str_buff;
-    l2_string_create(&token_str_buff);
+    l2_string token_str_buff = { 0 }; /* only created for the literals which are not taken from buffer directly */
 
     while(1) {
         ch = l2_char_stream_next_char(token_stream_p->char_stream_p);
@@ -74,29 +353,33 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
             case 0x0:
                 t.current_col = cols;
                 t.current_line = lines;
-                t.current_pos_at_stream = token_stream_p->char_stream_p->chars_vector_current_pos;
+                t.current_pos_at_stream = token_stream_p->char_stream_p->chars_base + token_stream_p->char_stream_p->chars_current_pos;
 
                 if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '_') {
                     t.type = L2_TOKEN_IDENTIFIER;
-                    l2_string_push_char(&token_str_buff, ch);
+                    literal_begin = char_stream_p->chars_current_pos - 1;
+                    l2_char_stream_read_span(char_stream_p, L2_CHAR_CLASS_ID);
                     fa_state = 0x1;
 
                 } else if (ch == '0') {
                     t.type = L2_TOKEN_INTEGER_LITERAL;
-                    l2_string_push_char(&token_str_buff, ch);
+                    literal_begin = char_stream_p->chars_current_pos - 1;
                     fa_state = 0x2;
 
                 } else if (ch >= '1' && ch <= '9') {
                     t.type = L2_TOKEN_INTEGER_LITERAL;
-                    l2_string_push_char(&token_str_buff, ch);
+                    literal_begin = char_stream_p->chars_current_pos - 1;
+                    l2_char_stream_read_span(char_stream_p, L2_CHAR_CLASS_DIGIT);
                     fa_state = 0x3;
 
                 } else if (ch == '\'') {
                     t.type = L2_TOKEN_INTEGER_LITERAL;
+                    l2_string_create(&token_str_buff);
                     fa_state = 0x4;
 
                 } else if (ch == '\"') {
                     t.type = L2_TOKEN_STRING_LITERAL;
+                    l2_string_create(&token_str_buff);
                     fa_state = 0x5;
 
                 } else if (ch == '{') {
@@ -157,10 +440,10 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                     if (ch == '=') {
                         t.type = L2_TOKEN_DIV_ASSIGN;
                     } else if (ch == '/') {
-						do {
-							ch = l2_char_stream_next_char(token_stream_p->char_stream_p);
-						} while (ch != '\n' && ch != EOF);
-		    		} else {
+                        /* the comment is skipped, and the lexing goes on */
+                        l2_char_stream_skip_line(token_stream_p->char_stream_p);
+                        break;
+                    } else {
                         l2_char_stream_rollback(token_stream_p->char_stream_p);
                     }
                     goto ret;
@@ -304,6 +587,7 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                     goto ret;
 
                 } else if (l2_char_is_blank(ch)) {
+                    l2_char_stream_skip_blanks(token_stream_p->char_stream_p);
 
                 } else if (ch == L2_EOF) {
                     t.type = L2_TOKEN_TERMINATOR;
@@ -318,19 +602,18 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
             case 0x1: /* handle identifier or keyword */
                 if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '_' || (ch >= '0' && ch <= '9')) {
-                    l2_string_push_char(&token_str_buff, ch);
+                    /* the chars stay in buffer */
 
                 } else {
                     l2_char_stream_rollback(token_stream_p->char_stream_p);
-                    char *keyword_p = l2_token_stream_str_keyword(&token_str_buff);
-                    if (keyword_p) {
+                    l2_keyword keyword = l2_token_stream_str_keyword(char_stream_p->chars_p + literal_begin, char_stream_p->chars_current_pos - literal_begin);
+                    if (keyword != L2_KW_NOT_KEYWORD) {
                         t.type = L2_TOKEN_KEYWORD;
-                        //l2_string_destroy(&token_str_buff);
-                        t.u.c_str = keyword_p;
+                        t.u.keyword = keyword;
                     } else {
                         t.type = L2_TOKEN_IDENTIFIER;
-                        l2_string_create(&t.u.str);
-                        l2_string_strcpy(&t.u.str, &token_str_buff);
+                        t.u.id.str_p = l2_intern_pool_intern(g_parser_p->intern_pool_p, char_stream_p->chars_p + literal_begin, char_stream_p->chars_current_pos - literal_begin);
+                        t.u.id.atom = l2_intern_atom(t.u.id.str_p);
                     }
                     goto ret;
 
@@ -339,19 +622,16 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
             case 0x2: /* handle oct and hex number literal ( begin with 0 ) */
                 if (ch == 'X' || ch == 'x') {
-                    l2_string_push_char(&token_str_buff, ch);
                     fa_state = 0x20;
 
                 } else if (ch >= '0' && ch <= '9') {
                     if (ch >= '8') {
                         l2_parsing_error(L2_PARSING_ERROR_ILLEGAL_NUMBER_IN_AN_OCTAL_LITERAL, lines, cols, ch);
                     }
-                    l2_string_push_char(&token_str_buff, ch);
                     fa_state = 0x21;
 
 				} else if (ch == '.') {
 					t.type = L2_TOKEN_REAL_LITERAL;
-					l2_string_push_char(&token_str_buff, ch);
 					fa_state = 0x31;
 
 				} else { /* get 0 */
@@ -364,7 +644,6 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
             case 0x20: /* handle hex number literal */
                 if ((ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F')) {
-                    l2_string_push_char(&token_str_buff, ch);
                     fa_state = 0x200;
 
                 } else {
@@ -375,11 +654,10 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
             case 0x200: /* handle hex number literal */
                 if ((ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F')) {
-                    l2_string_push_char(&token_str_buff, ch);
 
                 } else {
-                    t.u.integer = l2_cast_hex_str_to_int(&(l2_string_get_str_p(&token_str_buff)[2]));
-                    l2_char_stream_rollback(token_stream_p->char_stream_p);
+                    l2_char_stream_rollback(char_stream_p);
+                    t.u.integer = l2_cast_hex_chars_to_int(char_stream_p->chars_p + literal_begin + 2, char_stream_p->chars_current_pos - literal_begin - 2);
                     goto ret;
 
                 }
@@ -390,11 +668,10 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                     if (ch >= '8') {
                         l2_parsing_error(L2_PARSING_ERROR_ILLEGAL_NUMBER_IN_AN_OCTAL_LITERAL, lines, cols, ch);
                     }
-                    l2_string_push_char(&token_str_buff, ch);
 
                 } else {
-                    t.u.integer = l2_cast_octal_str_to_int(&(l2_string_get_str_p(&token_str_buff)[1]));
-                    l2_char_stream_rollback(token_stream_p->char_stream_p);
+                    l2_char_stream_rollback(char_stream_p);
+                    t.u.integer = l2_cast_octal_chars_to_int(char_stream_p->chars_p + literal_begin + 1, char_stream_p->chars_current_pos - literal_begin - 1);
                     goto ret;
 
                 }
@@ -402,23 +679,21 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
             case 0x3: /* handle dec number literal ( begin with 1 ~ 9 ) */
                 if (ch >= '0' && ch <= '9') {
-                    l2_string_push_char(&token_str_buff, ch);
 
                 } else if (ch == '.') {
                     t.type = L2_TOKEN_REAL_LITERAL;
-                    l2_string_push_char(&token_str_buff, ch);
                     fa_state = 0x31;
 
                 } else {
-                    t.u.integer = l2_cast_decimal_str_to_int(l2_string_get_str_p(&token_str_buff));
-                    l2_char_stream_rollback(token_stream_p->char_stream_p);
+                    l2_char_stream_rollback(char_stream_p);
+                    t.u.integer = l2_cast_decimal_chars_to_int(char_stream_p->chars_p + literal_begin, char_stream_p->chars_current_pos - literal_begin);
                     goto ret;
                 }
                 break;
 
             case 0x31: /* handle real number literal ( begin with 1 ~ 9 ) */
                 if (ch >= '0' && ch <= '9') {
-                    l2_string_push_char(&token_str_buff, ch);
+                    l2_char_stream_read_span(char_stream_p, L2_CHAR_CLASS_DIGIT);
                     fa_state = 0x32;
 
                 } else {
@@ -428,12 +703,11 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
             case 0x32: /* handle real number literal ( begin with 1 ~ 9 ) */
                 if (ch >= '0' && ch <= '9') {
-                    l2_string_push_char(&token_str_buff, ch);
                     fa_state = 0x32;
 
                 } else {
-                    t.u.real = l2_cast_real_str_to_int(l2_string_get_str_p(&token_str_buff));
-                    l2_char_stream_rollback(token_stream_p->char_stream_p);
+                    l2_char_stream_rollback(char_stream_p);
+                    t.u.real = l2_cast_real_chars_to_real(char_stream_p->chars_p + literal_begin, char_stream_p->chars_current_pos - literal_begin);
                     goto ret;
                 }
                 break;
@@ -492,6 +766,7 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                 } else if (ch >= '0' && ch <= '7') {
                     char seq[4];
                     int i;
+                    seq[0] = ch;
                     for (i = 1; i < 3; i++) {
                         ch = l2_char_stream_next_char(token_stream_p->char_stream_p);
                         if (ch >= '0' && ch <= '7') {
@@ -502,8 +777,7 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                             break;
                         }
                     }
-                    seq[i] = '\0';
-                    l2_string_push_char(&token_str_buff, (char)l2_cast_octal_str_to_int(seq));
+                    l2_string_push_char(&token_str_buff, (char)l2_cast_octal_chars_to_int(seq, i));
                     fa_state = 0x400;
                     break;
 
@@ -525,7 +799,7 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                         break;
                     }
                     seq[2] = '\0';
-                    l2_string_push_char(&token_str_buff, (char)l2_cast_hex_str_to_int(seq));
+                    l2_string_push_char(&token_str_buff, (char)l2_cast_hex_chars_to_int(seq, 2));
                     fa_state = 0x400;
                     break;
 
@@ -558,8 +832,8 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                 break;
 
             case 0x5: /* handle string literal */
-                if (ch == '\"') {
-                    l2_string_push_char(&token_str_buff, '\0');
+                if (ch == '\"') { /* the empty string is interned as well */
+                    t.u.str_p = l2_intern_pool_intern(g_parser_p->intern_pool_p, "", 0);
                     goto ret;
 
                 } else if (ch == '\\') {
@@ -611,6 +885,7 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                 } else if (ch >= '0' && ch <= '7') {
                     char seq[4];
                     int i;
+                    seq[0] = ch;
                     for (i = 1; i < 3; i++) {
                         ch = l2_char_stream_next_char(token_stream_p->char_stream_p);
                         if (ch >= '0' && ch <= '7') {
@@ -621,8 +896,7 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                             break;
                         }
                     }
-                    seq[i] = '\0';
-                    l2_string_push_char(&token_str_buff, (char)l2_cast_octal_str_to_int(seq));
+                    l2_string_push_char(&token_str_buff, (char)l2_cast_octal_chars_to_int(seq, i));
                     fa_state = 0x500;
                     break;
 
@@ -641,12 +915,12 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
                     } else {
                         seq[1] = '\0';
                         l2_char_stream_rollback(token_stream_p->char_stream_p);
-                        l2_string_push_char(&token_str_buff, (char)l2_cast_hex_str_to_int(seq));
+                        l2_string_push_char(&token_str_buff, (char)l2_cast_hex_chars_to_int(seq, 1));
                         fa_state = 0x500;
                         break;
                     }
                     seq[2] = '\0';
-                    l2_string_push_char(&token_str_buff, (char)l2_cast_hex_str_to_int(seq));
+                    l2_string_push_char(&token_str_buff, (char)l2_cast_hex_chars_to_int(seq, 2));
                     fa_state = 0x500;
                     break;
 
@@ -665,8 +939,7 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
             case 0x500:
                 if (ch == '\"') {
-                    l2_string_create(&t.u.str);
-                    l2_string_strcpy(&t.u.str, &token_str_buff);
+                    t.u.str_p = l2_intern_pool_intern(g_parser_p->intern_pool_p, l2_string_get_str_p(&token_str_buff), l2_string_len(&token_str_buff));
                     goto ret;
 
                 } else if (ch == '\\') {
@@ -686,44 +959,172 @@ l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p) {
 
     ret:
 
-    l2_string_destroy(&token_str_buff);
+    if (l2_string_avail(&token_str_buff))
+        l2_string_destroy(&token_str_buff);
 
-    l2_vector_append(&token_stream_p->token_vector, &t);
-    token_stream_p->token_vector_current_pos += 1;
-    return (l2_token *)l2_vector_tail(&token_stream_p->token_vector);
+    l2_token_stream_append(token_stream_p, &t);
 }
 
 
 
 void l2_token_stream_rollback(l2_token_stream *token_stream_p) {
     l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    l2_assert(token_stream_p->token_vector_current_pos > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE);
-    token_stream_p->token_vector_current_pos -= 1;
+    l2_assert(token_stream_p->tokens_current_pos > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE);
+    token_stream_p->tokens_current_pos -= 1;
 }
 
-char *l2_token_stream_str_keyword(l2_string *str_p) {
-    int i;
-    for (i = 0; i < sizeof(g_l2_token_keywords) / sizeof(char *); i++) {
-        if (l2_string_equal_c(str_p, g_l2_token_keywords[i])) {
-            return g_l2_token_keywords[i];
-        }
-    }
-    return L2_NULL_PTR;
+/* the str is a keyword only if it is the keyword in the slot of its hash */
+l2_keyword l2_token_stream_str_keyword(const char *s, int len) {
+    l2_keyword keyword;
+
+    if (len > L2_TOKEN_KEYWORD_MAX_LEN) return L2_KW_NOT_KEYWORD;
+
+    keyword = g_l2_token_keyword_slots[L2_TOKEN_KEYWORD_HASH(s, len)];
+    if (keyword != L2_KW_NOT_KEYWORD && strncmp(s, g_l2_token_keywords[keyword], len) == 0 && g_l2_token_keywords[keyword][len] == '\0')
+        return keyword;
+
+    return L2_KW_NOT_KEYWORD;
 }
 
 l2_token *l2_token_stream_current_token(l2_token_stream *token_stream_p) {
     l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    l2_assert(token_stream_p->token_vector_current_pos > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE);
-    return (l2_token *)l2_vector_at(&token_stream_p->token_vector, token_stream_p->token_vector_current_pos - 1);;
+    l2_assert(token_stream_p->tokens_current_pos > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE);
+    return l2_token_stream_decode(token_stream_p, token_stream_p->tokens_current_pos - 1, &token_stream_p->current_token);
 }
 
 int l2_token_stream_get_pos(l2_token_stream *token_stream_p) {
     l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    return token_stream_p->token_vector_current_pos;
+    return token_stream_p->tokens_current_pos;
 }
 
 void l2_token_stream_set_pos(l2_token_stream *token_stream_p, int pos) {
     l2_assert(token_stream_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    l2_assert(pos > 0 && pos <= token_stream_p->token_vector.size, L2_INTERNAL_ERROR_OUT_OF_RANGE);
-    token_stream_p->token_vector_current_pos = pos;
+    l2_assert(pos > 0 && pos <= token_stream_p->tokens_count, L2_INTERNAL_ERROR_OUT_OF_RANGE);
+    token_stream_p->tokens_current_pos = pos;
+}
+
+int l2_token_stream_jump(l2_token_stream *token_stream_p, int pos) {
+    if (pos < token_stream_p->tokens_base)
+        return l2_token_stream_kept_token(token_stream_p, pos)->jump_pos;
+
+    return token_stream_p->jumps_p[pos - token_stream_p->tokens_base];
+}
+
+/* the pos of the end of bracket at pos, the tokens are lexed until it is found ( in streaming mode ),
+ * L2_TOKEN_NO_JUMP is returned if the bracket is not closed before the terminator
+ * */
+int l2_token_stream_find_end(l2_token_stream *token_stream_p, int pos) {
+    while (l2_token_stream_jump(token_stream_p, pos) == L2_TOKEN_NO_JUMP) {
+        if (token_stream_p->types_p[token_stream_p->tokens_count - token_stream_p->tokens_base - 1] == L2_TOKEN_TERMINATOR)
+            return L2_TOKEN_NO_JUMP;
+        l2_token_stream_fill(token_stream_p);
+    }
+    return l2_token_stream_jump(token_stream_p, pos);
+}
+
+/* the type of the token after the end of bracket, which is the n-th next token, e.g. the ';' of "( expr ) ;",
+ * L2_TOKEN_TERMINATOR is returned if the bracket is not closed
+ * */
+l2_token_type l2_token_stream_peek_type_after_bracket(l2_token_stream *token_stream_p, int n) {
+    int pos = token_stream_p->tokens_current_pos + n - 1;
+
+    l2_token_stream_peek_type(token_stream_p, n);
+    if ((pos = l2_token_stream_find_end(token_stream_p, pos)) == L2_TOKEN_NO_JUMP)
+        return L2_TOKEN_TERMINATOR;
+
+    return l2_token_stream_peek_type(token_stream_p, pos - token_stream_p->tokens_current_pos + 2);
+}
+
+/* forward to the end of the innermost bracket which encloses the next token, e.g. the '}' of current block,
+ * the tokens skipped are not parsed, the position is not changed if the next token is not inside any bracket
+ * */
+void l2_token_stream_skip_to_end(l2_token_stream *token_stream_p) {
+    int pos = token_stream_p->tokens_current_pos;
+
+    switch (l2_token_stream_peek_type(token_stream_p, 1)) {
+        case L2_TOKEN_RBRACE:
+        case L2_TOKEN_RP:
+        case L2_TOKEN_RBRACKET:
+            return; /* the next token is the end */
+
+        case L2_TOKEN_LBRACE:
+        case L2_TOKEN_LP:
+        case L2_TOKEN_LBRACKET:
+            /* the bracket enclosing the next one is linked from the end of it */
+            if ((pos = l2_token_stream_find_end(token_stream_p, pos)) == L2_TOKEN_NO_JUMP) {
+                token_stream_p->tokens_current_pos = token_stream_p->tokens_count - 1;
+                return;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if ((pos = l2_token_stream_jump(token_stream_p, pos)) == L2_TOKEN_NO_JUMP) return;
+
+    /* the terminator is the end if the bracket is not closed */
+    if ((pos = l2_token_stream_find_end(token_stream_p, pos)) == L2_TOKEN_NO_JUMP)
+        pos = token_stream_p->tokens_count - 1;
+
+    token_stream_p->tokens_current_pos = pos;
+}
+
+/* the tokens in range are kept when they are released, the range pinned inside another one is kept with it */
+void l2_token_stream_pin(l2_token_stream *token_stream_p, int begin_pos, int end_pos) {
+    l2_token_range range, *ranges_p;
+    int i;
+
+    if (begin_pos < token_stream_p->tokens_base) return; /* it is in segment already */
+
+    for (i = 0; i < (int)token_stream_p->pinned_ranges.size; i++) {
+        range = *l2_token_range_vector_at(&token_stream_p->pinned_ranges, i);
+        if (range.begin_pos <= begin_pos && end_pos <= range.end_pos) return;
+    }
+
+    /* keep the ranges in order of pos */
+    range.begin_pos = begin_pos;
+    range.end_pos = end_pos;
+    l2_token_range_vector_append(&token_stream_p->pinned_ranges, range);
+    ranges_p = token_stream_p->pinned_ranges.vector_p;
+    for (i = token_stream_p->pinned_ranges.size - 1; i > 0 && ranges_p[i - 1].begin_pos > begin_pos; i--) {
+        ranges_p[i] = ranges_p[i - 1];
+        ranges_p[i - 1] = range;
+    }
+}
+
+/* release the tokens before current one ( which is kept for rollback ), and the chars lexed into them,
+ * the pinned ranges before are moved into segments, and the range not complete yet keeps the tokens from it
+ * */
+void l2_token_stream_release(l2_token_stream *token_stream_p) {
+    int pos = token_stream_p->tokens_current_pos - 1, kept_count, i, j;
+    l2_token_range *ranges_p = token_stream_p->pinned_ranges.vector_p;
+    l2_token_segment segment;
+
+    for (i = token_stream_p->pinned_ranges.size - 1; i >= 0; i--) {
+        if (ranges_p[i].begin_pos < pos && ranges_p[i].end_pos > pos)
+            pos = ranges_p[i].begin_pos;
+    }
+
+    if (pos <= token_stream_p->tokens_base) return;
+
+    for (i = 0; i < (int)token_stream_p->pinned_ranges.size && ranges_p[i].end_pos <= pos; i++) {
+        segment.range = ranges_p[i];
+        segment.tokens_p = l2_storage_mem_new(g_parser_p->storage_p, (segment.range.end_pos - segment.range.begin_pos) * sizeof(l2_token));
+        for (j = segment.range.begin_pos; j < segment.range.end_pos; j++)
+            l2_token_stream_decode(token_stream_p, j, &segment.tokens_p[j - segment.range.begin_pos]);
+        l2_token_segment_vector_append(&token_stream_p->segments, segment);
+    }
+    memmove(ranges_p, ranges_p + i, (token_stream_p->pinned_ranges.size - i) * sizeof(l2_token_range));
+    token_stream_p->pinned_ranges.size -= i;
+
+    l2_char_stream_release(token_stream_p->char_stream_p, token_stream_p->poses_p[pos - token_stream_p->tokens_base]);
+
+    i = pos - token_stream_p->tokens_base;
+    kept_count = token_stream_p->tokens_count - pos;
+    memmove(token_stream_p->types_p, token_stream_p->types_p + i, kept_count * sizeof(unsigned char));
+    memmove(token_stream_p->payloads_p, token_stream_p->payloads_p + i, kept_count * sizeof(l2_token_payload));
+    memmove(token_stream_p->poses_p, token_stream_p->poses_p + i, kept_count * sizeof(int));
+    memmove(token_stream_p->jumps_p, token_stream_p->jumps_p + i, kept_count * sizeof(int));
+    token_stream_p->tokens_base = pos;
 }
@@ -3,7 +3,9 @@
 
 #include "../l2_tpl/l2_string.h"
 #include "../l2_tpl/l2_vector.h"
+#include "../l2_tpl/l2_stack.h"
 #include "l2_char_stream.h"
+#include "l2_intern.h"
 
 extern char *g_l2_token_keywords[];
 
@@ -63,11 +65,13 @@ typedef enum _l2_token_type {
     L2_TOKEN_BIT_XOR_ASSIGN, /* ^= */
     L2_TOKEN_BIT_OR_ASSIGN, /* |= */
     L2_TOKEN_COMMA, /* , */
-    L2_TOKEN_SEMICOLON /* ; */
+    L2_TOKEN_SEMICOLON /* ; ( the last type, the types loaded from token cache are checked against it ) */
 
 }l2_token_type;
 
 typedef enum _l2_keywords {
+    L2_KW_NOT_KEYWORD = -1,
+
     L2_KW_TRUE,
     L2_KW_FALSE,
     L2_KW_VAR,
@@ -85,35 +89,103 @@ typedef enum _l2_keywords {
 
 }l2_keyword;
 
+/* the decoded token, which is returned by the token stream */
 typedef struct _l2_token {
     l2_token_type type;
     union {
-        char *c_str;
-        l2_string str;
+        l2_keyword keyword; /* classified by the lexer, so keywords are compared as integers */
+        char *str_p; /* string literal */
+        struct {
+            char *str_p; /* interned by the intern pool of parser */
+            l2_atom atom;
+        }id;
         double real;
-        int integer;
+        int64_t integer;
     }u;
     int current_pos_at_stream;
     int current_line;
     int current_col;
+    int jump_pos; /* see jumps_p of l2_token_stream */
 }l2_token;
 
+/* the payload stored for each token, the strs are interned */
+typedef union _l2_token_payload {
+    l2_keyword keyword;
+    char *str_p;
+    double real;
+    int64_t integer;
+}l2_token_payload;
+
+/* the range of tokens [begin_pos, end_pos) */
+typedef struct _l2_token_range {
+    int begin_pos;
+    int end_pos;
+}l2_token_range;
+
+/* the tokens of range kept after the tokens around them have been released,
+ * they are decoded since the line starts of them would be released from char stream
+ * */
+typedef struct _l2_token_segment {
+    l2_token_range range;
+    l2_token *tokens_p;
+}l2_token_segment;
+
+L2_VECTOR_DEFINE(l2_token_range)
+L2_VECTOR_DEFINE(l2_token_segment)
+L2_STACK_DEFINE(int)
+
+#define L2_TOKEN_NO_JUMP (-1) /* the end of bracket has not been lexed yet, or the token is not inside any bracket */
+
+/* the tokens are stored as parallel arrays of types, payloads and positions at char stream,
+ * the lines and cols are derived from the positions when the tokens are decoded,
+ * in streaming mode the tokens before tokens_base are released except the ranges pinned ( procedure bodies ),
+ * the positions of tokens always count from the beginning of source,
+ * the jumps link the brackets, so that the tokens of a block are skipped without parsing them:
+ * the jump of '{', '(' and '[' is the pos of its end, the jump of the other token is the pos of the innermost bracket
+ * which encloses it ( the end of bracket is enclosed by the outer one ), so the end of current block is found by two lookups
+ * */
 typedef struct _l2_token_stream {
-    l2_vector token_vector;
-    int token_vector_current_pos;
+    unsigned char *types_p;
+    l2_token_payload *payloads_p;
+    int *poses_p;
+    int *jumps_p;
+    int tokens_count;
+    int tokens_max_count; /* the capacity of arrays, which keep the tokens from tokens_base */
+    int tokens_current_pos;
+    int tokens_base; /* the pos of first token in arrays */
+    l2_token_range_vector pinned_ranges; /* the ranges pinned in arrays, which are kept as segments when released */
+    l2_token_segment_vector segments; /* in order of pos */
+    int segment_hint; /* the segment found by last lookup */
+    int_stack opens; /* the pos of brackets not closed yet in the tokens lexed */
+    l2_token next_token; /* decoded by l2_token_stream_next_token */
+    l2_token current_token; /* decoded by l2_token_stream_current_token, stays until the current token is got again */
+    l2_token peek_token; /* decoded by l2_token_stream_peek_token */
     l2_char_stream *char_stream_p;
+    char *cache_path_p; /* the path of token cache, null if the source is not a file */
 }l2_token_stream;
 
-l2_token_stream *l2_token_stream_create(FILE *fp);
+l2_token_stream *l2_token_stream_create(FILE *fp, const char *source_path_p);
 void l2_token_stream_destroy(l2_token_stream *token_stream_p);
+void l2_token_stream_reserve(l2_token_stream *token_stream_p, int max_count);
+void l2_token_stream_link(l2_token_stream *token_stream_p, int pos);
+l2_token *l2_token_stream_decode(l2_token_stream *token_stream_p, int pos, l2_token *t);
 
 l2_token *l2_token_stream_next_token(l2_token_stream *token_stream_p);
 l2_token *l2_token_stream_current_token(l2_token_stream *token_stream_p);
+l2_token_type l2_token_stream_peek_type(l2_token_stream *token_stream_p, int n);
+l2_token *l2_token_stream_peek_token(l2_token_stream *token_stream_p, int n);
+l2_token_type l2_token_stream_peek_type_after_bracket(l2_token_stream *token_stream_p, int n);
+boolean l2_token_stream_match(l2_token_stream *token_stream_p, l2_token_type type);
+boolean l2_token_stream_match_keyword(l2_token_stream *token_stream_p, l2_keyword keyword);
+boolean l2_token_stream_match_id(l2_token_stream *token_stream_p, l2_atom atom);
 int l2_token_stream_get_pos(l2_token_stream *token_stream_p);
 void l2_token_stream_set_pos(l2_token_stream *token_stream_p, int pos);
 void l2_token_stream_rollback(l2_token_stream *token_stream_p);
+void l2_token_stream_skip_to_end(l2_token_stream *token_stream_p);
+void l2_token_stream_pin(l2_token_stream *token_stream_p, int begin_pos, int end_pos);
+void l2_token_stream_release(l2_token_stream *token_stream_p);
 
-char *l2_token_stream_str_keyword(l2_string *str_p);
+l2_keyword l2_token_stream_str_keyword(const char *s, int len);
 
 
 #endif
\ No newline at end of file
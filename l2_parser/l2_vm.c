@@ -0,0 +1,327 @@
+#include "l2_vm.h"
+#include "l2_parse.h"
+#include "l2_ast_eval.h"
+#include "l2_ast_resolve.h"
+#include "l2_call_stack.h"
+#include "../l2_drv/l2_error.h"
+
+extern l2_parser *g_parser_p;
+
+/* the two operands on the top of operand stack, the operation is performed as DUALISTIC unless both of them are integer */
+#define _integer_operands \
+right_p = vm_p->operand_stack.stack_p + vm_p->operand_stack.size - 1; \
+left_p = right_p - 1; \
+if (left_p->val_type != L2_EXPR_VAL_TYPE_INTEGER || right_p->val_type != L2_EXPR_VAL_TYPE_INTEGER) goto dualistic;
+
+/* the result takes the place of left operand */
+#define _integer_arith(opr) \
+left_p->val.integer = left_p->val.integer opr right_p->val.integer; \
+vm_p->operand_stack.size -= 1;
+
+#define _integer_compare(opr) \
+left_p->val.bool = left_p->val.integer opr right_p->val.integer; \
+left_p->val_type = L2_EXPR_VAL_TYPE_BOOL; \
+vm_p->operand_stack.size -= 1;
+
+l2_vm *l2_vm_create() {
+    l2_vm *vm_p;
+    vm_p = l2_storage_mem_new_with_zero(g_parser_p->storage_p, sizeof(l2_vm));
+    vm_p->bytecode_p = l2_bytecode_create();
+    l2_expr_info_stack_create(&vm_p->operand_stack);
+    return vm_p;
+}
+
+void l2_vm_destroy(l2_vm *vm_p) {
+    l2_expr_info_stack_destroy(&vm_p->operand_stack);
+    l2_bytecode_destroy(vm_p->bytecode_p);
+    l2_storage_mem_delete(g_parser_p->storage_p, vm_p);
+}
+
+void l2_vm_push(l2_vm *vm_p, l2_expr_info expr_info) {
+    l2_expr_info_stack_push_back(&vm_p->operand_stack, expr_info);
+}
+
+/* the compiler keeps the pushes and pops balanced, so the operand stack is popped without checking */
+l2_expr_info l2_vm_pop(l2_vm *vm_p) {
+    return vm_p->operand_stack.stack_p[--vm_p->operand_stack.size];
+}
+
+/* the symbol at the address resolved, null if it is not defined yet */
+l2_symbol_node *l2_vm_get_symbol_node(l2_scope *scope_p, l2_ast_addr addr) {
+    int hops;
+
+    for (hops = addr.hops; hops > 0; hops--)
+        scope_p = scope_p->upper_p;
+
+    return scope_p->symbol_table_p->slots_p[addr.slot];
+}
+
+/* create new procedure scope, and bind the real parameters popped from operand stack to the formal parameters */
+l2_scope *l2_vm_bind_params(l2_vm *vm_p, l2_ast_node *expr_p, l2_procedure *procedure_p) {
+    vm_p->operand_stack.size -= expr_p->u.call.args_count;
+    return l2_ast_eval_bind_params(expr_p, procedure_p, vm_p->operand_stack.stack_p + vm_p->operand_stack.size);
+}
+
+/* call the procedure, the values of real parameters are on the top of operand stack */
+int l2_vm_call(l2_vm *vm_p, l2_ast_node *expr_p, int ret_pos, l2_scope **scope_pp) {
+    l2_procedure procedure;
+    l2_call_frame call_frame;
+
+    procedure = l2_ast_eval_get_procedure(expr_p, *scope_pp);
+    call_frame.procedure_scope_p = l2_vm_bind_params(vm_p, expr_p, &procedure);
+
+    call_frame.ret_pos = ret_pos;
+    call_frame.ret_scope_p = *scope_pp;
+    l2_call_stack_push_frame(g_parser_p->call_stack_p, call_frame, expr_p->line, expr_p->col);
+
+    *scope_pp = call_frame.procedure_scope_p;
+    return procedure.entry_pos;
+}
+
+/* call the procedure in tail position, the current procedure is escaped and its frame is taken over by the callee,
+ * it is called as usual if the frame could not be reused, and ret_pos is the instruction returning its value
+ * */
+int l2_vm_tail_call(l2_vm *vm_p, l2_ast_node *expr_p, int ret_pos, l2_scope **scope_pp) {
+    l2_procedure procedure;
+    l2_scope *procedure_scope_p;
+    int args_count = expr_p->u.call.args_count;
+
+    procedure = l2_ast_eval_get_procedure(expr_p, *scope_pp);
+    if (!l2_call_stack_could_reuse_frame(g_parser_p->call_stack_p, *scope_pp, &procedure,
+                                         vm_p->operand_stack.stack_p + vm_p->operand_stack.size - args_count, args_count))
+        return l2_vm_call(vm_p, expr_p, ret_pos, scope_pp);
+
+    /* the scopes inside current procedure are escaped along with it */
+    l2_scope_escape_scope(l2_scope_find_nearest_scope_by_type(*scope_pp, L2_SCOPE_TYPE_PROCEDURE));
+
+    procedure_scope_p = l2_vm_bind_params(vm_p, expr_p, &procedure);
+    l2_call_stack_reuse_frame(g_parser_p->call_stack_p, procedure_scope_p);
+
+    *scope_pp = procedure_scope_p;
+    return procedure.entry_pos;
+}
+
+/* procedure execution complete, restore call frame */
+int l2_vm_return(l2_vm *vm_p, l2_expr_info ret_expr_info, l2_scope **scope_pp) {
+    l2_call_frame call_frame;
+
+    call_frame = l2_call_stack_pop_frame(g_parser_p->call_stack_p);
+    l2_scope_escape_scope(call_frame.procedure_scope_p); /* escape from procedure scope */
+
+    l2_vm_push(vm_p, ret_expr_info);
+    *scope_pp = call_frame.ret_scope_p;
+    return call_frame.ret_pos;
+}
+
+void l2_vm_run(l2_vm *vm_p, int entry_pos, l2_scope *scope_p) {
+    /* the bytecode would not be appended while running, so the instructions could be addressed directly */
+    l2_bytecode_inst *insts = vm_p->bytecode_p->inst_vec.vector_p, *inst_p;
+    l2_expr_info left_expr_info, right_expr_info, *left_p, *right_p;
+    l2_symbol_node *symbol_node_p;
+    l2_scope *upper_scope_p;
+    int pos = entry_pos;
+
+    while (1) {
+        inst_p = &insts[pos++];
+
+        switch (inst_p->opcode) {
+            case L2_BYTECODE_PUSH_INTEGER:
+                right_expr_info.val_type = L2_EXPR_VAL_TYPE_INTEGER;
+                right_expr_info.val.integer = inst_p->u.integer;
+                l2_vm_push(vm_p, right_expr_info);
+                break;
+
+            case L2_BYTECODE_PUSH_REAL:
+                right_expr_info.val_type = L2_EXPR_VAL_TYPE_REAL;
+                right_expr_info.val.real = inst_p->u.real;
+                l2_vm_push(vm_p, right_expr_info);
+                break;
+
+            case L2_BYTECODE_PUSH_BOOL:
+                right_expr_info.val_type = L2_EXPR_VAL_TYPE_BOOL;
+                right_expr_info.val.bool = inst_p->u.bool;
+                l2_vm_push(vm_p, right_expr_info);
+                break;
+
+            case L2_BYTECODE_POP:
+                l2_vm_pop(vm_p);
+                break;
+
+            case L2_BYTECODE_LOAD:
+                l2_vm_push(vm_p, l2_ast_eval_identifier(inst_p->u.node_p, scope_p));
+                break;
+
+            case L2_BYTECODE_ASSIGN:
+                right_expr_info = l2_vm_pop(vm_p);
+                l2_vm_push(vm_p, l2_ast_eval_assign(inst_p->u.node_p, scope_p, right_expr_info));
+                break;
+
+            case L2_BYTECODE_DUALISTIC:
+            dualistic:
+                right_expr_info = l2_vm_pop(vm_p);
+                left_expr_info = l2_vm_pop(vm_p);
+                l2_vm_push(vm_p, l2_ast_eval_dualistic(inst_p->u.node_p, left_expr_info, right_expr_info));
+                break;
+
+            case L2_BYTECODE_UNITARY:
+                right_expr_info = l2_vm_pop(vm_p);
+                l2_vm_push(vm_p, l2_ast_eval_unitary(inst_p->u.node_p, right_expr_info));
+                break;
+
+            case L2_BYTECODE_ADD: _integer_operands _integer_arith(+) break;
+            case L2_BYTECODE_SUB: _integer_operands _integer_arith(-) break;
+            case L2_BYTECODE_MUL: _integer_operands _integer_arith(*) break;
+
+            case L2_BYTECODE_DIV:
+                _integer_operands
+                if (!right_p->val.integer) goto dualistic; /* divided by zero is reported by DUALISTIC */
+                _integer_arith(/)
+                break;
+
+            case L2_BYTECODE_MOD:
+                _integer_operands
+                if (!right_p->val.integer) goto dualistic;
+                _integer_arith(%)
+                break;
+
+            case L2_BYTECODE_BIT_AND: _integer_operands _integer_arith(&) break;
+            case L2_BYTECODE_BIT_XOR: _integer_operands _integer_arith(^) break;
+            case L2_BYTECODE_BIT_OR: _integer_operands _integer_arith(|) break;
+            case L2_BYTECODE_LSHIFT: _integer_operands _integer_arith(<<) break;
+            case L2_BYTECODE_RSHIFT: _integer_operands _integer_arith(>>) break;
+
+            case L2_BYTECODE_EQUAL: _integer_operands _integer_compare(==) break;
+            case L2_BYTECODE_NOT_EQUAL: _integer_operands _integer_compare(!=) break;
+            case L2_BYTECODE_GREAT_THAN: _integer_operands _integer_compare(>) break;
+            case L2_BYTECODE_GREAT_EQUAL_THAN: _integer_operands _integer_compare(>=) break;
+            case L2_BYTECODE_LESS_THAN: _integer_operands _integer_compare(<) break;
+            case L2_BYTECODE_LESS_EQUAL_THAN: _integer_operands _integer_compare(<=) break;
+
+            case L2_BYTECODE_LOAD_ADDR:
+                symbol_node_p = l2_vm_get_symbol_node(scope_p, inst_p->addr);
+                if (symbol_node_p && symbol_node_p->symbol.type == L2_SYMBOL_TYPE_INTEGER) {
+                    right_expr_info.val_type = L2_EXPR_VAL_TYPE_INTEGER;
+                    right_expr_info.val.integer = symbol_node_p->symbol.u.integer;
+                    l2_vm_push(vm_p, right_expr_info);
+                    break;
+                }
+
+                /* the other values and the errors */
+                l2_vm_push(vm_p, l2_ast_eval_identifier(inst_p->u.node_p, scope_p));
+                break;
+
+            case L2_BYTECODE_STORE_ADDR:
+                right_p = vm_p->operand_stack.stack_p + vm_p->operand_stack.size - 1;
+                symbol_node_p = l2_vm_get_symbol_node(scope_p, inst_p->addr);
+                if (symbol_node_p && right_p->val_type == L2_EXPR_VAL_TYPE_INTEGER) {
+                    symbol_node_p->symbol.type = L2_SYMBOL_TYPE_INTEGER;
+                    symbol_node_p->symbol.u.integer = right_p->val.integer;
+                    break;
+                }
+
+                right_expr_info = l2_vm_pop(vm_p);
+                l2_vm_push(vm_p, l2_ast_eval_assign(inst_p->u.node_p, scope_p, right_expr_info));
+                break;
+
+            case L2_BYTECODE_CALL:
+                pos = l2_vm_call(vm_p, inst_p->u.node_p, pos, &scope_p);
+                break;
+
+            case L2_BYTECODE_TAIL_CALL:
+                pos = l2_vm_tail_call(vm_p, inst_p->u.node_p, pos, &scope_p);
+                break;
+
+            case L2_BYTECODE_DEFINE_VAR:
+                l2_ast_eval_define_var(inst_p->u.node_p, scope_p);
+                break;
+
+            case L2_BYTECODE_INIT_VAR:
+                l2_ast_eval_init_var(inst_p->u.node_p, scope_p, l2_vm_pop(vm_p));
+                break;
+
+            case L2_BYTECODE_DEFINE_PROCEDURE:
+                l2_ast_eval_define_procedure(inst_p->u.node_p, scope_p, inst_p->arg);
+                break;
+
+            case L2_BYTECODE_EVAL:
+                l2_ast_eval_print(inst_p->u.node_p, l2_vm_pop(vm_p));
+                break;
+
+            case L2_BYTECODE_RETURN:
+                right_expr_info.val_type = L2_EXPR_VAL_NO_VAL;
+                pos = l2_vm_return(vm_p, right_expr_info, &scope_p);
+                break;
+
+            case L2_BYTECODE_RETURN_VAL:
+                pos = l2_vm_return(vm_p, l2_vm_pop(vm_p), &scope_p);
+                break;
+
+            case L2_BYTECODE_ENTER_SCOPE:
+                scope_p = l2_scope_create_scope(scope_p, L2_SCOPE_CREATE_SUB_SCOPE, inst_p->arg);
+                break;
+
+            case L2_BYTECODE_LEAVE_SCOPE:
+                upper_scope_p = scope_p->upper_p;
+                l2_scope_escape_scope(scope_p);
+                scope_p = upper_scope_p;
+                break;
+
+            case L2_BYTECODE_JUMP:
+                pos = inst_p->arg;
+                break;
+
+            case L2_BYTECODE_JUMP_IF_FALSE:
+                right_expr_info = l2_vm_pop(vm_p);
+
+                if (right_expr_info.val_type != L2_EXPR_VAL_TYPE_BOOL)
+                    l2_parsing_error(L2_PARSING_ERROR_EXPR_NOT_BOOL, inst_p->u.node_p->line, inst_p->u.node_p->col);
+
+                if (!right_expr_info.val.bool) pos = inst_p->arg;
+                break;
+
+            case L2_BYTECODE_SHORT_CIRCUIT:
+                if (l2_ast_eval_short_circuit(inst_p->u.node_p, vm_p->operand_stack.stack_p[vm_p->operand_stack.size - 1]))
+                    pos = inst_p->arg;
+                break;
+
+            case L2_BYTECODE_HALT:
+                return;
+
+            default:
+                l2_internal_error(L2_INTERNAL_ERROR_UNREACHABLE_CODE, "无效的字节码指令");
+        }
+    }
+}
+
+void l2_vm_program() {
+    l2_vm *vm_p = g_parser_p->vm_p;
+    l2_ast_node *stmt_p;
+    l2_ast_mark mark;
+    int entry_pos;
+
+    if (_is_stream) {
+        /* each stmt is compiled and executed as soon as it has been parsed,
+         * its nodes and instructions are released after that, unless it defines procedures
+         * */
+        mark = l2_ast_get_mark();
+        while ((stmt_p = l2_ast_parse_stmt())) {
+            l2_ast_resolve_program(stmt_p);
+            entry_pos = l2_bytecode_compile(vm_p->bytecode_p, stmt_p);
+            l2_vm_run(vm_p, entry_pos, g_parser_p->global_scope_p);
+            if (l2_ast_release_since(&mark)) l2_bytecode_rollback(vm_p->bytecode_p, entry_pos);
+            _stream_release
+            _repl /* prompt */
+        }
+
+        _if_type (L2_TOKEN_TERMINATOR)
+        {
+            /* reach the end of input */
+        } _throw_unexpected_token
+
+    } else {
+        /* parse and compile the whole source once, then execute the bytecode */
+        stmt_p = l2_ast_parse_program();
+        l2_ast_resolve_program(stmt_p);
+        l2_vm_run(vm_p, l2_bytecode_compile(vm_p->bytecode_p, stmt_p), g_parser_p->global_scope_p);
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef _L2_VM_H_
+#define _L2_VM_H_
+
+#include "../l2_tpl/l2_stack.h"
+#include "l2_bytecode.h"
+#include "l2_scope.h"
+#include "l2_eval.h"
+
+typedef struct _l2_vm {
+    l2_bytecode *bytecode_p;
+    l2_expr_info_stack operand_stack;
+}l2_vm;
+
+l2_vm *l2_vm_create();
+void l2_vm_destroy(l2_vm *vm_p);
+
+void l2_vm_run(l2_vm *vm_p, int entry_pos, l2_scope *scope_p);
+void l2_vm_program();
+
+#endif
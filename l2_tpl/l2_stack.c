@@ -1,3 +1,4 @@
+#include "string.h"
 #include "l2_stack.h"
 #include "../l2_drv/l2_assert.h"
 #include "../l2_parser/l2_parse.h"
@@ -11,7 +12,7 @@ boolean l2_stack_avail(const l2_stack *stack) {
 void l2_stack_create(l2_stack *stack, const l2_mem_size size_of_single_elem) {
     l2_assert(stack, L2_INTERNAL_ERROR_NULL_POINTER);
     stack->size = 0;
-    stack->max_size = 100;
+    stack->max_size = L2_STACK_INIT_MAX_SIZE;
     stack->stack_p = l2_storage_mem_new(g_parser_p->storage_p, size_of_single_elem * stack->max_size);
     stack->single_size = size_of_single_elem;
 }
@@ -24,14 +25,27 @@ void l2_stack_destroy(l2_stack *stack) {
     stack->stack_p = L2_NULL_PTR;
 }
 
+/* make sure the stack could hold max_size elements without reallocation */
+void l2_stack_reserve(l2_stack *stack, l2_stack_size max_size) {
+    l2_assert(stack, L2_INTERNAL_ERROR_NULL_POINTER);
+    if (max_size <= stack->max_size) return;
+    stack->stack_p = l2_storage_mem_renew(g_parser_p->storage_p, stack->stack_p, max_size * stack->single_size);
+    stack->max_size = max_size;
+}
+
+void l2_stack_shrink_to_fit(l2_stack *stack) {
+    l2_assert(stack, L2_INTERNAL_ERROR_NULL_POINTER);
+    if (stack->size == stack->max_size || stack->size == 0) return;
+    stack->stack_p = l2_storage_mem_renew(g_parser_p->storage_p, stack->stack_p, stack->size * stack->single_size);
+    stack->max_size = stack->size;
+}
+
+/* the capacity grows twice, so the pushing is amortized O(1) */
 void l2_stack_push_back(l2_stack *stack, const void *data) {
     l2_assert(stack, L2_INTERNAL_ERROR_NULL_POINTER);
-    int i;
     if (stack->size >= stack->max_size)
-        stack->stack_p = l2_storage_mem_resize(g_parser_p->storage_p, stack->stack_p, stack->max_size * stack->single_size, (stack->max_size += 100) * stack->single_size);
-    for (i = 0; i < stack->single_size; i++) {
-        ((char *)(stack->stack_p))[stack->size * stack->single_size + i] = ((char *)data)[i];
-    }
+        l2_stack_reserve(stack, stack->max_size ? stack->max_size * 2 : L2_STACK_INIT_MAX_SIZE);
+    memcpy((char *)stack->stack_p + stack->size * stack->single_size, data, stack->single_size);
     stack->size += 1;
 }
 
@@ -3,6 +3,10 @@
 
 #include "../l2_mem/l2_storage.h"
 #include "l2_common_type.h"
+#include "l2_vector.h"
+#include "../l2_drv/l2_assert.h"
+
+#define L2_STACK_INIT_MAX_SIZE 8
 
 typedef struct _l2_stack {
     void *stack_p;
@@ -14,8 +18,53 @@ typedef struct _l2_stack {
 
 void l2_stack_create(l2_stack *stack, l2_mem_size size_of_single_elem);
 void l2_stack_destroy(l2_stack *stack);
+void l2_stack_reserve(l2_stack *stack, l2_stack_size max_size);
+void l2_stack_shrink_to_fit(l2_stack *stack);
 void l2_stack_push_back(l2_stack *stack, const void *data);
 void* l2_stack_pop(l2_stack *stack);
 void* l2_stack_back(const l2_stack *stack);
 
-#endif
\ No newline at end of file
+/* define the type-specialized stack T_stack, whose elements are stored as array of T */
+#define L2_STACK_DEFINE(T) \
+typedef struct _##T##_stack { \
+    T *stack_p; \
+    l2_stack_size size; \
+    l2_stack_size max_size; \
+}T##_stack; \
+\
+static inline void T##_stack_create(T##_stack *stack) { \
+    stack->size = 0; \
+    stack->max_size = L2_STACK_INIT_MAX_SIZE; \
+    stack->stack_p = l2_vector_mem_new(stack->max_size * sizeof(T)); \
+} \
+\
+static inline void T##_stack_destroy(T##_stack *stack) { \
+    l2_vector_mem_delete(stack->stack_p); \
+    stack->stack_p = L2_NULL_PTR; \
+    stack->size = 0; \
+    stack->max_size = 0; \
+} \
+\
+static inline void T##_stack_reserve(T##_stack *stack, l2_stack_size max_size) { \
+    if (max_size <= stack->max_size) return; \
+    stack->stack_p = l2_vector_mem_renew(stack->stack_p, max_size * sizeof(T)); \
+    stack->max_size = max_size; \
+} \
+\
+static inline void T##_stack_push_back(T##_stack *stack, T elem) { \
+    if (stack->size >= stack->max_size) \
+        T##_stack_reserve(stack, stack->max_size ? stack->max_size * 2 : L2_STACK_INIT_MAX_SIZE); \
+    stack->stack_p[stack->size++] = elem; \
+} \
+\
+static inline T *T##_stack_pop(T##_stack *stack) { \
+    l2_assert(stack->size > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE); \
+    return &stack->stack_p[--stack->size]; \
+} \
+\
+static inline T *T##_stack_back(const T##_stack *stack) { \
+    l2_assert(stack->size > 0, L2_INTERNAL_ERROR_OUT_OF_RANGE); \
+    return &stack->stack_p[stack->size - 1]; \
+}
+
+#endif
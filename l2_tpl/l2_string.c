@@ -12,8 +12,9 @@ boolean l2_string_avail(const l2_string *str) {
 void l2_string_create(l2_string *str) {
     l2_assert(str, L2_INTERNAL_ERROR_NULL_POINTER);
     str->len = 0;
-    str->max_len = 100;
+    str->max_len = L2_STRING_INIT_MAX_LEN;
     str->str_p = l2_storage_mem_new(g_parser_p->storage_p, (str->max_len + 1) * sizeof(char));
+    str->str_p[0] = L2_STRING_END_MASK;
 }
 
 void l2_string_destroy(l2_string *str) {
@@ -24,32 +25,54 @@ void l2_string_destroy(l2_string *str) {
     str->str_p = L2_NULL_PTR;
 }
 
+/* make sure the string could hold max_len characters ( and the end mask ) without reallocation */
+void l2_string_reserve(l2_string *str, l2_string_size max_len) {
+    l2_assert(str, L2_INTERNAL_ERROR_NULL_POINTER);
+    if (max_len <= str->max_len) return;
+    str->str_p = l2_storage_mem_renew(g_parser_p->storage_p, str->str_p, (max_len + 1) * sizeof(char));
+    str->max_len = max_len;
+}
+
+void l2_string_shrink_to_fit(l2_string *str) {
+    l2_assert(str, L2_INTERNAL_ERROR_NULL_POINTER);
+    if (str->len == str->max_len) return;
+    str->str_p = l2_storage_mem_renew(g_parser_p->storage_p, str->str_p, (str->len + 1) * sizeof(char));
+    str->max_len = str->len;
+}
+
+/* the capacity grows twice, so the appending is amortized O(1) */
+void l2_string_grow(l2_string *str, l2_string_size min_len) {
+    l2_string_size max_len = str->max_len ? str->max_len : L2_STRING_INIT_MAX_LEN;
+    while (max_len < min_len) max_len = max_len * 2 + 1;
+    l2_string_reserve(str, max_len);
+}
+
 void l2_string_push_char(l2_string *str, const char ch) {
     l2_assert(str, L2_INTERNAL_ERROR_NULL_POINTER);
     if (str->len >= str->max_len)
-        str->str_p = l2_storage_mem_resize(g_parser_p->storage_p, str->str_p, (str->max_len + 1) * sizeof(char),
-                                           ((str->max_len += 100) + 1) *
-                                                           sizeof(char));
+        l2_string_grow(str, str->len + 1);
     str->str_p[str->len++] = ch;
     str->str_p[str->len] = L2_STRING_END_MASK;
 }
 
+void l2_string_strcat_n(l2_string *dest, const char *src_str_p, l2_string_size len) {
+    if (dest->len + len > dest->max_len)
+        l2_string_grow(dest, dest->len + len);
+    memcpy(dest->str_p + dest->len, src_str_p, len);
+    dest->len += len;
+    dest->str_p[dest->len] = L2_STRING_END_MASK;
+}
+
 void l2_string_strcat_c(l2_string *dest, const char *src_str_p) {
     l2_assert(dest, L2_INTERNAL_ERROR_NULL_POINTER);
     l2_assert(src_str_p, L2_INTERNAL_ERROR_NULL_POINTER);
-    char *p;
-    for (p = (char *)src_str_p; *p != L2_STRING_END_MASK; p++) {
-        l2_string_push_char(dest, *p);
-    }
+    l2_string_strcat_n(dest, src_str_p, strlen(src_str_p));
 }
 
 void l2_string_strcat(l2_string *dest, const l2_string *src) {
     l2_assert(dest, L2_INTERNAL_ERROR_NULL_POINTER);
     l2_assert(src, L2_INTERNAL_ERROR_NULL_POINTER);
-    int i;
-    for (i = 0; i < src->len; i++) {
-        l2_string_push_char(dest, src->str_p[i]);
-    }
+    l2_string_strcat_n(dest, src->str_p, src->len);
 }
 
 void l2_string_strcpy_c(l2_string *dest, const char *src_str_p) {
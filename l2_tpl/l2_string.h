@@ -4,6 +4,8 @@
 #include "l2_common_type.h"
 #include "../l2_mem/l2_storage.h"
 
+#define L2_STRING_INIT_MAX_LEN 15 /* the end mask is not counted */
+
 typedef struct _l2_string {
     char *str_p;
     l2_string_size len;
@@ -13,7 +15,10 @@ typedef struct _l2_string {
 boolean l2_string_avail(const l2_string *str);
 void l2_string_create(l2_string *str);
 void l2_string_destroy(l2_string *str);
+void l2_string_reserve(l2_string *str, l2_string_size max_len);
+void l2_string_shrink_to_fit(l2_string *str);
 void l2_string_push_char(l2_string *str, char ch);
+void l2_string_strcat_n(l2_string *dest, const char *src_str_p, l2_string_size len);
 void l2_string_strcat_c(l2_string *dest, const char *src_str_p);
 void l2_string_strcat(l2_string *dest, const l2_string *src);
 void l2_string_strcpy_c(l2_string *dest, const char *src_str_p);
@@ -1,3 +1,4 @@
+#include "string.h"
 #include "l2_vector.h"
 #include "../l2_drv/l2_assert.h"
 #include "../l2_parser/l2_parse.h"
@@ -7,7 +8,7 @@ extern l2_parser *g_parser_p;
 void l2_vector_create(l2_vector *vec, l2_mem_size size_of_single_elem) {
     l2_assert(vec, L2_INTERNAL_ERROR_NULL_POINTER);
     vec->size = 0;
-    vec->max_size = 100;
+    vec->max_size = L2_VECTOR_INIT_MAX_SIZE;
     vec->vector_p = l2_storage_mem_new(g_parser_p->storage_p, size_of_single_elem * vec->max_size);
     vec->single_size = size_of_single_elem;
 }
@@ -20,17 +21,44 @@ void l2_vector_destroy(l2_vector *vec) {
     vec->vector_p = L2_NULL_PTR;
 }
 
+/* make sure the vector could hold max_size elements without reallocation */
+void l2_vector_reserve(l2_vector *vec, l2_vector_size max_size) {
+    l2_assert(vec, L2_INTERNAL_ERROR_NULL_POINTER);
+    if (max_size <= vec->max_size) return;
+    vec->vector_p = l2_storage_mem_renew(g_parser_p->storage_p, vec->vector_p, max_size * vec->single_size);
+    vec->max_size = max_size;
+}
+
+void l2_vector_shrink_to_fit(l2_vector *vec) {
+    l2_assert(vec, L2_INTERNAL_ERROR_NULL_POINTER);
+    if (vec->size == vec->max_size || vec->size == 0) return;
+    vec->vector_p = l2_storage_mem_renew(g_parser_p->storage_p, vec->vector_p, vec->size * vec->single_size);
+    vec->max_size = vec->size;
+}
+
+/* the capacity grows twice, so the appending is amortized O(1) */
+void l2_vector_grow(l2_vector *vec, l2_vector_size min_size) {
+    l2_vector_size max_size = vec->max_size ? vec->max_size : L2_VECTOR_INIT_MAX_SIZE;
+    while (max_size < min_size) max_size *= 2;
+    l2_vector_reserve(vec, max_size);
+}
+
 void l2_vector_append(l2_vector *vec, const void *data) {
     l2_assert(vec, L2_INTERNAL_ERROR_NULL_POINTER);
-    int i;
     if (vec->size >= vec->max_size)
-        vec->vector_p = l2_storage_mem_resize(g_parser_p->storage_p, vec->vector_p, vec->max_size * vec->single_size, (vec->max_size += 100) * vec->single_size);
-    for (i = 0; i < vec->single_size; i++) {
-        ((char *)(vec->vector_p))[vec->size * vec->single_size + i] = ((char *)data)[i];
-    }
+        l2_vector_grow(vec, vec->size + 1);
+    memcpy((char *)vec->vector_p + vec->size * vec->single_size, data, vec->single_size);
     vec->size += 1;
 }
 
+void l2_vector_append_n(l2_vector *vec, const void *data, l2_vector_size count) {
+    l2_assert(vec, L2_INTERNAL_ERROR_NULL_POINTER);
+    if (vec->size + count > vec->max_size)
+        l2_vector_grow(vec, vec->size + count);
+    memcpy((char *)vec->vector_p + vec->size * vec->single_size, data, count * vec->single_size);
+    vec->size += count;
+}
+
 void *l2_vector_tail(const l2_vector *vec) {
     l2_assert(vec, L2_INTERNAL_ERROR_NULL_POINTER);
     return (char *)vec->vector_p + ((vec->size - 1) * vec->single_size);
@@ -41,4 +69,14 @@ void *l2_vector_at(const l2_vector *vec, int pos) {
     return (char *)vec->vector_p + (pos * vec->single_size);
 }
 
+void *l2_vector_mem_new(l2_mem_size mem_size) {
+    return l2_storage_mem_new(g_parser_p->storage_p, mem_size);
+}
 
+void *l2_vector_mem_renew(void *old_void_ptr, l2_mem_size mem_size) {
+    return l2_storage_mem_renew(g_parser_p->storage_p, old_void_ptr, mem_size);
+}
+
+void l2_vector_mem_delete(void *void_ptr) {
+    l2_storage_mem_delete(g_parser_p->storage_p, void_ptr);
+}
@@ -4,6 +4,8 @@
 #include "../l2_mem/l2_storage.h"
 #include "l2_common_type.h"
 
+#define L2_VECTOR_INIT_MAX_SIZE 8
+
 typedef struct _l2_vector {
     void *vector_p;
     l2_vector_size size;
@@ -13,8 +15,66 @@ typedef struct _l2_vector {
 
 void l2_vector_create(l2_vector *vec, l2_mem_size size_of_single_elem);
 void l2_vector_destroy(l2_vector *vec);
+void l2_vector_reserve(l2_vector *vec, l2_vector_size max_size);
+void l2_vector_shrink_to_fit(l2_vector *vec);
 void l2_vector_append(l2_vector *vec, const void *data);
+void l2_vector_append_n(l2_vector *vec, const void *data, l2_vector_size count);
 void* l2_vector_tail(const l2_vector *vec);
 void* l2_vector_at(const l2_vector *vec, int pos);
 
-#endif
\ No newline at end of file
+/* the memory of type-specialized vectors and stacks is managed by storage of parser */
+void *l2_vector_mem_new(l2_mem_size mem_size);
+void *l2_vector_mem_renew(void *old_void_ptr, l2_mem_size mem_size);
+void l2_vector_mem_delete(void *void_ptr);
+
+/* define the type-specialized vector T_vector, whose elements are stored as array of T,
+ * the accessors are inline, and the capacity grows twice as l2_vector
+ * */
+#define L2_VECTOR_DEFINE(T) \
+typedef struct _##T##_vector { \
+    T *vector_p; \
+    l2_vector_size size; \
+    l2_vector_size max_size; \
+}T##_vector; \
+\
+static inline void T##_vector_create(T##_vector *vec) { \
+    vec->size = 0; \
+    vec->max_size = L2_VECTOR_INIT_MAX_SIZE; \
+    vec->vector_p = l2_vector_mem_new(vec->max_size * sizeof(T)); \
+} \
+\
+static inline void T##_vector_destroy(T##_vector *vec) { \
+    l2_vector_mem_delete(vec->vector_p); \
+    vec->vector_p = L2_NULL_PTR; \
+    vec->size = 0; \
+    vec->max_size = 0; \
+} \
+\
+static inline void T##_vector_reserve(T##_vector *vec, l2_vector_size max_size) { \
+    if (max_size <= vec->max_size) return; \
+    vec->vector_p = l2_vector_mem_renew(vec->vector_p, max_size * sizeof(T)); \
+    vec->max_size = max_size; \
+} \
+\
+static inline void T##_vector_shrink_to_fit(T##_vector *vec) { \
+    if (vec->size == vec->max_size || vec->size == 0) return; \
+    vec->vector_p = l2_vector_mem_renew(vec->vector_p, vec->size * sizeof(T)); \
+    vec->max_size = vec->size; \
+} \
+\
+static inline T *T##_vector_append(T##_vector *vec, T elem) { \
+    if (vec->size >= vec->max_size) \
+        T##_vector_reserve(vec, vec->max_size ? vec->max_size * 2 : L2_VECTOR_INIT_MAX_SIZE); \
+    vec->vector_p[vec->size] = elem; \
+    return &vec->vector_p[vec->size++]; \
+} \
+\
+static inline T *T##_vector_at(const T##_vector *vec, l2_vector_size pos) { \
+    return &vec->vector_p[pos]; \
+} \
+\
+static inline T *T##_vector_tail(const T##_vector *vec) { \
+    return &vec->vector_p[vec->size - 1]; \
+}
+
+#endif